@@ -1,14 +1,27 @@
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "RunAction.hh"
+#include "ImportanceBiasing.hh"
+#include "RegionStepLimiter.hh"
+#include "SimRunManager.hh"
+#include "EventSeeder.hh"
+#include "ProgressMonitor.hh"
+#include "PhysicsTableCache.hh"
+#include "SimulationServer.hh"
 
-#include "G4RunManagerFactory.hh"
 #include "G4SteppingVerbose.hh"
 #include "G4UImanager.hh"
 #include "QBBC.hh"
 #include "FTFP_BERT_HP.hh"
 
+#ifndef G4SIM_NO_VIS
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
+#endif
+#include "G4UImessenger.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4PhysListFactory.hh"
 #include "G4EmLivermorePhysics.hh"
 #include "G4RadioactiveDecayPhysics.hh"
@@ -23,6 +36,93 @@
 #include "Randomize.hh"
 
 #include <cstdlib>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Print the command line usage
+ */
+void PrintUsage()
+{
+  G4cout << "Usage: G4sim [--physics <list>] [--em <option>] [--processes <N>]\n"
+         << "             [--seed <S>] [--first-event <F>] [--n-events <N>]\n"
+         << "             [--progress-file <file>] [--table-cache <dir>] [--headless]\n"
+         << "             [--daemon <socket>] [macro]\n"
+         << "  --physics <list>  Geant4 reference physics list (default FTFP_BERT_HP,\n"
+         << "                    or $G4SIM_PHYSICS_LIST), e.g. QBBC, FTFP_BERT, Shielding\n"
+         << "  --em <option>     EM constructor suffix (or $G4SIM_EM_OPTION):\n"
+         << "                    EM0, EMV, EMX, EMY, EMZ, LIV, PEN, GS, SS, WVI, LE\n"
+         << "  --processes <N>   Split every run over N processes forked after initialisation;\n"
+         << "                    their output is merged into the output file (needs a macro)\n"
+         << "  --seed <S>        Master seed: every event is seeded from S, the run and its number\n"
+         << "  --first-event <F> Number the events of every run from F (default 0)\n"
+         << "  --n-events <N>    Run N events per /run/beamOn instead of the macro's count\n"
+         << "  --progress-file <file>  Keep a JSON file with the live progress of the run\n"
+         << "  --table-cache <dir>  Retrieve the physics tables from this cache, or build and\n"
+         << "                    store them there (or $G4SIM_TABLE_CACHE)\n"
+         << "  --headless        Batch only: no visualisation or UI session, no trajectories\n"
+         << "                    (always on in builds with WITH_GEANT4_UIVIS=OFF; needs a macro)\n"
+         << "  --daemon <socket> Initialise once (after the optional macro), then serve commands\n"
+         << "                    on this Unix domain socket until shutdown; implies --headless\n"
+         << "  macro             Macro file to execute; without it an interactive session starts"
+         << G4endl;
+}
+
+/**
+ * @brief Combine a reference list name and an EM option into a factory name
+ * @param list Reference physics list, e.g. FTFP_BERT_HP
+ * @param em EM option with or without leading underscore, e.g. EMZ or _LIV (may be empty)
+ * @return Name understood by G4PhysListFactory, e.g. FTFP_BERT_HP_EMZ
+ */
+std::string PhysicsListName(const std::string& list, const std::string& em)
+{
+  if (em.empty() || em[0] == '_') return list + em;
+  // G4PhysListFactory spells these with a double underscore
+  if (em == "GS" || em == "SS" || em == "LE") return list + "__" + em;
+  return list + "_" + em;
+}
+
+/**
+ * @class HeadlessVisMessenger
+ * @brief Accepts /vis/disable and /vis/enable when there is no vis manager
+ *
+ * Batch macros (and the ones written by the web dashboard) switch visualisation
+ * off with /vis/disable; without this the command would not be found and the
+ * macro would stop.  Every other /vis/ command still fails.
+ */
+class HeadlessVisMessenger : public G4UImessenger
+{
+public:
+  HeadlessVisMessenger() {
+    fDir = new G4UIdirectory("/vis/");
+    fDir->SetGuidance("Visualisation is not available in headless mode");
+
+    fDisableCmd = new G4UIcmdWithoutParameter("/vis/disable", this);
+    fDisableCmd->SetGuidance("No-op: visualisation is off in headless mode");
+
+    fEnableCmd = new G4UIcmdWithABool("/vis/enable", this);
+    fEnableCmd->SetGuidance("No-op: visualisation cannot be enabled in headless mode");
+    fEnableCmd->SetParameterName("flag", true);
+    fEnableCmd->SetDefaultValue(true);
+  }
+  ~HeadlessVisMessenger() override {
+    delete fDisableCmd;
+    delete fEnableCmd;
+    delete fDir;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String) override {
+    if (cmd == fEnableCmd)
+      G4cerr << "Headless mode: /vis/enable ignored, visualisation is not available" << G4endl;
+  }
+private:
+  G4UIdirectory*           fDir;
+  G4UIcmdWithoutParameter* fDisableCmd;
+  G4UIcmdWithABool*        fEnableCmd;
+};
+
+} // namespace
 
 /**
  * @brief The main function of the program.
@@ -38,12 +138,84 @@
  */
 int main(int argc,char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Parse the command line: options first, then an optional macro file.
+  // The physics list can also be chosen through the environment.
+  //
+  std::string physicsList = "FTFP_BERT_HP";
+  std::string emOption;
+  if (const char* env = std::getenv("G4SIM_PHYSICS_LIST")) physicsList = env;
+  if (const char* env = std::getenv("G4SIM_EM_OPTION")) emOption = env;
+  if (const char* env = std::getenv("G4SIM_TABLE_CACHE")) PhysicsTableCache::SetDirectory(env);
+  G4String macroFile;
+  G4int nProcesses = 0;
+  G4long masterSeed = 0;
+  G4long firstEvent = -1;
+  G4int nEvents = -1;
+  G4String daemonSocket;
+#ifdef G4SIM_NO_VIS
+  G4bool headless = true;    // built without visualisation and UI drivers
+#else
+  G4bool headless = false;
+#endif
+
+  for (G4int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--physics" && i + 1 < argc) {
+      physicsList = argv[++i];
+    } else if (arg == "--em" && i + 1 < argc) {
+      emOption = argv[++i];
+    } else if (arg == "--processes" && i + 1 < argc) {
+      nProcesses = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      masterSeed = std::atol(argv[++i]);
+    } else if (arg == "--first-event" && i + 1 < argc) {
+      firstEvent = std::atol(argv[++i]);
+    } else if (arg == "--n-events" && i + 1 < argc) {
+      nEvents = std::atoi(argv[++i]);
+    } else if (arg == "--progress-file" && i + 1 < argc) {
+      ProgressMonitor::SetFileName(argv[++i]);
+    } else if (arg == "--table-cache" && i + 1 < argc) {
+      PhysicsTableCache::SetDirectory(argv[++i]);
+    } else if (arg == "--headless") {
+      headless = true;
+    } else if (arg == "--daemon" && i + 1 < argc) {
+      daemonSocket = argv[++i];
+      headless = true;
+    } else if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      return 0;
+    } else if (arg.rfind("--", 0) == 0) {
+      G4cerr << "Unknown or incomplete option: " << arg << G4endl;
+      PrintUsage();
+      return 1;
+    } else {
+      macroFile = arg;
+    }
+  }
+
+  if (nProcesses > 1 && macroFile.empty()) {
+    G4cerr << "--processes needs a macro file" << G4endl;
+    return 1;
+  }
+
+  if (headless && macroFile.empty() && daemonSocket.empty()) {
+    G4cerr << "Headless mode needs a macro file" << G4endl;
+    return 1;
+  }
+
+  if (!daemonSocket.empty() && nProcesses > 1) {
+    G4cerr << "--daemon cannot be combined with --processes" << G4endl;
+    return 1;
+  }
+
+  // Detect interactive mode (if no macro) and define UI session
   //
+#ifndef G4SIM_NO_VIS
   G4UIExecutive* ui = nullptr;
-  if ( argc == 1 ) { 
+  if ( macroFile.empty() && !headless ) { 
     ui = new G4UIExecutive(argc, argv); 
   }
+#endif
 
   // Optionally: choose a different Random engine...
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
@@ -52,10 +224,19 @@ int main(int argc,char** argv)
   G4int precision = 4;
   G4SteppingVerbose::UseBestUnit(precision);
 
-  // Construct the default run manager
+  // Construct the run manager: serial, optionally splitting every run over
+  // processes forked after initialisation
   //
-  auto* runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial);
+  auto* runManager = new SimRunManager();
+  if (nProcesses > 1) {
+    SimRunManager::SetNumberOfProcesses(nProcesses);
+    RunAction::SetMetadata("processes", std::to_string(nProcesses));
+  }
+
+  // Per-event seeding and event range (also /random/setMasterSeed, /random/setFirstEvent)
+  if (masterSeed != 0) EventSeeder::SetMasterSeed(masterSeed);
+  if (firstEvent >= 0) EventSeeder::SetFirstEvent(firstEvent);
+  EventSeeder::SetNumberOfEvents(nEvents);
 
   //runManager->SetNumberOfThreads(1);
 
@@ -65,12 +246,27 @@ int main(int argc,char** argv)
 
   runManager->SetUserInitialization(new DetectorConstruction());
 
-  // Physics list with high-precision neutron transport + radioactive decay
-  // Note: FTFP_BERT_HP already includes G4RadioactiveDecayPhysics
+  // Physics list: FTFP_BERT_HP (high-precision neutron transport) unless
+  // another reference list and/or EM option was requested
   G4PhysListFactory factory;
-  G4VModularPhysicsList* physicsList = factory.GetReferencePhysList("FTFP_BERT_HP");
-  physicsList->SetVerboseLevel(1);
-  runManager->SetUserInitialization(physicsList);
+  std::string physicsName = PhysicsListName(physicsList, emOption);
+  if (!factory.IsReferencePhysList(physicsName)) {
+    G4cerr << "Unknown physics list: " << physicsName << G4endl;
+    factory.AvailablePhysLists();
+    factory.AvailablePhysListsEM();
+    return 1;
+  }
+  G4cout << "Physics list: " << physicsName << G4endl;
+  G4VModularPhysicsList* physics = factory.GetReferencePhysList(physicsName);
+  physics->SetVerboseLevel(1);
+  // Applies the G4UserLimits of regions defined in the geometry JSON (only
+  // attached when the geometry at /run/initialize has limits)
+  physics->RegisterPhysics(new RegionStepLimiter());
+  // Importance sampling for volumes with an "importance" in the geometry JSON
+  physics->RegisterPhysics(new ImportanceBiasing());
+  runManager->SetUserInitialization(physics);
+  RunAction::SetMetadata("physics_list", physicsName);
+  PhysicsTableCache::SetPhysicsListName(physicsName);
 
   // Allow all radioactive isotopes to appear in the nuclide table.
   G4NuclideTable::GetInstance()->SetThresholdOfHalfLife(0.);
@@ -78,47 +274,76 @@ int main(int argc,char** argv)
   // User action initialization
   runManager->SetUserInitialization(new ActionInitialization());
 
-  // Initialize visualization
-  //
-  G4VisManager* visManager = new G4VisExecutive;
-  // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
-  // G4VisManager* visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
-
   // Get the pointer to the User Interface manager
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
+  // Initialize visualization, unless running headless: then no vis manager
+  // (nor its scene handlers) exists and trajectories are off unless the
+  // macro asks for them
+  //
+#ifndef G4SIM_NO_VIS
+  G4VisManager* visManager = nullptr;
+#endif
+  HeadlessVisMessenger* headlessMessenger = nullptr;
+  if (headless) {
+    headlessMessenger = new HeadlessVisMessenger();
+    UImanager->ApplyCommand("/tracking/storeTrajectory 0");
+    RunAction::SetMetadata("headless", "1");
+  } else {
+#ifndef G4SIM_NO_VIS
+    visManager = new G4VisExecutive;
+    // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
+    // G4VisManager* visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+#endif
+  }
+
   // Process macro or start UI session
   //
   G4String command = "/control/execute ";
   
-  if ( argc > 1 ) {
+  if ( !macroFile.empty() ) {
     // Execute the macro file provided as argument
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
+    UImanager->ApplyCommand(command+macroFile);
   }
-  else {
+  else if ( daemonSocket.empty() ) {
     // No macro argument - execute default vis.mac
     UImanager->ApplyCommand(command+"macros/vis.mac");
   }
 
+  // Daemon: pay the initialisation (geometry, physics tables) now, once,
+  // then serve commands until shutdown
+  //
+  G4int exitCode = 0;
+  if ( !daemonSocket.empty() ) {
+    RunAction::SetMetadata("daemon", "1");
+    UImanager->ApplyCommand("/run/initialize");
+    UImanager->ApplyCommand("/run/beamOn 0");
+    exitCode = SimulationServer::Serve(daemonSocket);
+  }
+
+#ifndef G4SIM_NO_VIS
   if ( ui ) {
     // Start interactive session (works with or without a macro argument)
     ui->SessionStart(); 
     delete ui; 
   }
+#endif
  
   // Job termination
   // Free the store: user actions, physics_list and detector_description are
   // owned and deleted by the run manager, so they should not be deleted
   // in the main() program !
 
+#ifndef G4SIM_NO_VIS
   delete visManager;
+#endif
+  delete headlessMessenger;
   delete runManager;
 
   // Use quick_exit to avoid spurious mutex warnings from Geant4 HP 
   // physics static destructors (known Geant4 11.x issue)
-  std::quick_exit(0);
+  std::quick_exit(exitCode);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
@@ -0,0 +1,569 @@
+/**
+ * @file G4sim_bench.cc
+ * @brief Micro-benchmarks of the hit pipeline, the geometry parser and the ROOT output
+ *
+ * Built with the CMake option G4SIM_BENCHMARKS.  Every case runs on synthetic,
+ * fixed-seed input and is repeated; the fastest repetition is reported, together
+ * with the number of heap allocations (counted by replacing the global operator
+ * new) so that regressions show up as numbers rather than impressions:
+ *
+ *   - geometry: GeometryParser::ConstructGeometry() on N boxes (10 .. 100k)
+ *   - hits:     ProcessHits() of every sensitive detector type on synthetic steps
+ *   - event:    EventAction::EndOfEventAction() in detailed and summary mode
+ *               at 1 .. 10k hits per event, including TTree::Fill()
+ *   - root:     writing and closing the output file of each event case
+ */
+
+#include "GeometryParser.hh"
+#include "MySensitiveDetector.hh"
+#include "SensitiveDetectorFactory.hh"
+#include "RunAction.hh"
+#include "EventAction.hh"
+
+#include "G4RunManager.hh"
+#include "G4VUserDetectorConstruction.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4EmStandardPhysics.hh"
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4Navigator.hh"
+#include "G4TouchableHandle.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+#include "G4coutDestination.hh"
+#include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// ── Allocation counting ─────────────────────────────────
+// Replacing the global operator new counts every heap allocation of the
+// process, including those made inside Geant4 and ROOT.
+
+namespace {
+std::atomic<long> gAllocations{0};
+std::atomic<long> gAllocatedBytes{0};
+
+void* CountedAlloc(std::size_t size)
+{
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  gAllocatedBytes.fetch_add(static_cast<long>(size), std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+}
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// ── Output handling ─────────────────────────────────────
+
+/// Swallows G4cout; G4cerr still reaches the terminal
+class QuietDestination : public G4coutDestination
+{
+  public:
+    G4int ReceiveG4cout(const G4String&) override { return 0; }
+    G4int ReceiveG4cerr(const G4String& msg) override { std::cerr << msg << std::flush; return 0; }
+};
+
+/// Stream buffer that drops everything (the parser also prints to std::cout)
+class NullBuffer : public std::streambuf
+{
+  protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+// ── Measurement ─────────────────────────────────────────
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief Time and allocations of one repetition */
+struct Measurement {
+    double seconds = 0.;     ///< Wall-clock time [s]
+    long allocations = 0;    ///< Heap allocations
+    long bytes = 0;          ///< Heap bytes allocated
+};
+
+/** @brief Accumulates the timed sections of one repetition */
+class Stopwatch
+{
+  public:
+    void Start() {
+      fAllocations = gAllocations.load();
+      fBytes = gAllocatedBytes.load();
+      fStart = Clock::now();
+    }
+    void Stop() {
+      fResult.seconds += std::chrono::duration<double>(Clock::now() - fStart).count();
+      fResult.allocations += gAllocations.load() - fAllocations;
+      fResult.bytes += gAllocatedBytes.load() - fBytes;
+    }
+    const Measurement& Result() const { return fResult; }
+  private:
+    Clock::time_point fStart;
+    long fAllocations = 0;
+    long fBytes = 0;
+    Measurement fResult;
+};
+
+/// Fastest of several repetitions (the least disturbed one)
+Measurement Best(const std::vector<Measurement>& runs)
+{
+  return *std::min_element(runs.begin(), runs.end(),
+                           [](const Measurement& a, const Measurement& b) { return a.seconds < b.seconds; });
+}
+
+/** @brief Command line settings */
+struct Options {
+    int repeat = 3;                 ///< Repetitions per case
+    long maxVolumes = 100000;       ///< Largest synthetic geometry
+    long hitsPerCase = 200000;      ///< Hits processed per event case and repetition
+    std::string csvFile;            ///< Optional CSV copy of the results
+    std::string rootFile = "G4sim_bench.root";
+};
+
+/** @brief One result row */
+struct Row {
+    std::string bench;   ///< Benchmark group
+    std::string variant; ///< Case within the group
+    double units;        ///< Work items per repetition (volumes, hits)
+    double events;       ///< Events per repetition (0 if not applicable)
+    Measurement m;       ///< Fastest repetition
+};
+
+std::ostream* gReport = nullptr;
+std::vector<Row> gRows;
+
+void PrintHeader(const std::string& title, const std::string& unit)
+{
+  *gReport << '\n' << title << '\n'
+           << "  " << std::left << std::setw(26) << "case" << std::right
+           << std::setw(10) << "items" << std::setw(12) << "time [ms]"
+           << std::setw(12) << ("ns/" + unit) << std::setw(12) << "events/s"
+           << std::setw(12) << ("allocs/" + unit) << std::setw(12) << ("B/" + unit) << '\n';
+}
+
+void Report(const std::string& bench, const std::string& variant, double units, double events,
+            const Measurement& m)
+{
+  gRows.push_back({bench, variant, units, events, m});
+  *gReport << "  " << std::left << std::setw(26) << variant << std::right
+           << std::setw(10) << static_cast<long>(units)
+           << std::fixed << std::setprecision(2) << std::setw(12) << 1e3 * m.seconds
+           << std::setprecision(1) << std::setw(12) << 1e9 * m.seconds / units;
+  if (events > 0) *gReport << std::setprecision(0) << std::setw(12) << events / m.seconds;
+  else            *gReport << std::setw(12) << "-";
+  *gReport << std::setprecision(2) << std::setw(12) << m.allocations / units
+           << std::setprecision(0) << std::setw(12) << m.bytes / units
+           << std::defaultfloat << '\n' << std::flush;
+}
+
+// ── Synthetic input ─────────────────────────────────────
+
+/// Edge length of the smallest cubic grid holding n cells
+long GridSide(long n)
+{
+  long side = 1;
+  while (side * side * side < n) side++;
+  return side;
+}
+
+/// Volume names longer than the small-string buffer, as in real geometries
+std::string CellName(long i)
+{
+  char name[32];
+  std::snprintf(name, sizeof(name), "scintillator_cell_%06ld", i);
+  return name;
+}
+
+/**
+ * @brief Geometry configuration with nVolumes boxes on a cubic grid in the world
+ * @param nVolumes Number of volumes (each its own solid, logical and physical volume)
+ * @param hitsCollection Hits collection of the cells ("" = not sensitive)
+ */
+json SyntheticGeometry(long nVolumes, const std::string& hitsCollection)
+{
+  const long side = GridSide(nVolumes);
+  const double pitch = 12., size = 10.;
+  const double world = side * pitch + 2 * pitch;
+
+  json config;
+  config["materials"] = {{"G4_Galactic", {{"type", "nist"}}}, {"G4_Si", {{"type", "nist"}}}};
+  config["world"] = {{"name", "World"}, {"g4name", "World"}, {"type", "box"}, {"material", "G4_Galactic"},
+                     {"dimensions", {{"x", world}, {"y", world}, {"z", world}}}};
+  config["volumes"] = json::array();
+  for (long i = 0; i < nVolumes; i++) {
+    const long ix = i % side, iy = (i / side) % side, iz = i / (side * side);
+    json volume = {{"name", CellName(i)}, {"type", "box"}, {"material", "G4_Si"},
+                   {"dimensions", {{"x", size}, {"y", size}, {"z", size}}},
+                   {"placements", json::array({{{"parent", "World"},
+                                                {"x", (ix - 0.5 * (side - 1)) * pitch},
+                                                {"y", (iy - 0.5 * (side - 1)) * pitch},
+                                                {"z", (iz - 0.5 * (side - 1)) * pitch}}})}};
+    if (!hitsCollection.empty()) volume["hitsCollectionName"] = hitsCollection;
+    config["volumes"].push_back(volume);
+  }
+  return config;
+}
+
+/// Cells of the detector used by the hit and event benchmarks
+constexpr long kCells = 125;
+constexpr double kPitch = 12. * mm;
+constexpr double kCellSize = 10. * mm;
+const char* const kCollection = "bench";
+
+/** @brief Builds the sensitive detector geometry through the GeometryParser */
+class BenchDetectorConstruction : public G4VUserDetectorConstruction
+{
+  public:
+    G4VPhysicalVolume* Construct() override {
+      fParser.LoadGeometryConfig(SyntheticGeometry(kCells, kCollection), "synthetic.json");
+      return fParser.ConstructGeometry();
+    }
+  private:
+    GeometryParser fParser;
+};
+
+/** @brief Electromagnetic physics only: cheap to initialise, enough for a run */
+class BenchPhysicsList : public G4VModularPhysicsList
+{
+  public:
+    BenchPhysicsList() { RegisterPhysics(new G4EmStandardPhysics(0)); }
+};
+
+/** @brief Step inputs drawn once from a fixed seed */
+struct StepInput {
+    G4TouchableHandle touchable;
+    G4ThreeVector position;
+    G4double edep;
+    G4double time;
+    G4double weight;
+    G4int trackID;
+};
+
+/**
+ * @brief Draw steps uniformly in the cells of the bench detector
+ * @param world World volume of the bench detector
+ * @param n Number of steps
+ */
+std::vector<StepInput> SyntheticSteps(G4VPhysicalVolume* world, size_t n)
+{
+  const long side = GridSide(kCells);
+
+  // One touchable per cell, located at the cell centre
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+  std::vector<G4TouchableHandle> touchables;
+  std::vector<G4ThreeVector> centres;
+  for (long i = 0; i < kCells; i++) {
+    const long ix = i % side, iy = (i / side) % side, iz = i / (side * side);
+    G4ThreeVector centre((ix - 0.5 * (side - 1)) * kPitch, (iy - 0.5 * (side - 1)) * kPitch,
+                         (iz - 0.5 * (side - 1)) * kPitch);
+    navigator.LocateGlobalPointAndSetup(centre, nullptr, false, true);
+    touchables.push_back(navigator.CreateTouchableHistoryHandle());
+    centres.push_back(centre);
+  }
+
+  std::mt19937_64 rng(12345);
+  std::uniform_int_distribution<long> cell(0, kCells - 1);
+  std::uniform_real_distribution<double> offset(-0.5 * kCellSize, 0.5 * kCellSize);
+  std::exponential_distribution<double> energy(1. / (50. * keV));
+  std::uniform_real_distribution<double> time(0., 100. * ns);
+
+  std::vector<StepInput> steps(n);
+  for (size_t i = 0; i < n; i++) {
+    const long c = cell(rng);
+    steps[i].touchable = touchables[c];
+    steps[i].position = centres[c] + G4ThreeVector(offset(rng), offset(rng), offset(rng));
+    steps[i].edep = energy(rng) + 1. * eV;
+    steps[i].time = time(rng);
+    steps[i].weight = 1.;
+    steps[i].trackID = static_cast<G4int>(i % 50) + 1;
+  }
+  return steps;
+}
+
+/** @brief A reusable step that the synthetic inputs are copied into */
+class SyntheticStep
+{
+  public:
+    SyntheticStep()
+    : fTrack(new G4DynamicParticle(G4Electron::Definition(), G4ThreeVector(0, 0, 1), 1. * MeV),
+             0., G4ThreeVector())
+    {
+      fStep.SetTrack(&fTrack);
+      fTrack.SetStep(&fStep);
+    }
+
+    G4Step* Set(const StepInput& in) {
+      fTrack.SetTrackID(in.trackID);
+      fStep.GetPreStepPoint()->SetTouchableHandle(in.touchable);
+      fStep.GetPreStepPoint()->SetWeight(in.weight);
+      fStep.GetPostStepPoint()->SetTouchableHandle(in.touchable);
+      fStep.GetPostStepPoint()->SetPosition(in.position);
+      fStep.GetPostStepPoint()->SetGlobalTime(in.time);
+      fStep.SetTotalEnergyDeposit(in.edep);
+      return &fStep;
+    }
+
+  private:
+    G4Step fStep;
+    G4Track fTrack;
+};
+
+/**
+ * @brief Open a new hits collection and record hits from the synthetic steps
+ * @param sd Sensitive detector
+ * @param steps Synthetic step inputs
+ * @param first Index of the first input to use
+ * @param n Number of hits
+ * @param watch If given, only the ProcessHits() calls are timed
+ * @return Hits of the event (owned by the caller)
+ */
+G4HCofThisEvent* RecordHits(G4VSensitiveDetector* sd, const std::vector<StepInput>& steps, size_t first,
+                            long n, SyntheticStep& step, Stopwatch* watch)
+{
+  auto* hce = new G4HCofThisEvent(G4SDManager::GetSDMpointer()->GetCollectionCapacity());
+  sd->Initialize(hce);
+  if (watch) watch->Start();
+  for (long i = 0; i < n; i++) {
+    sd->ProcessHits(step.Set(steps[(first + i) % steps.size()]), nullptr);
+  }
+  if (watch) watch->Stop();
+  return hce;
+}
+
+// ── Benchmarks ──────────────────────────────────────────
+
+/**
+ * @brief GeometryParser::ConstructGeometry() on synthetic geometries
+ * @details Runs before the detector of the other benchmarks is built: every
+ *          repetition empties the volume and solid stores again.
+ */
+void BenchGeometry(const Options& opt)
+{
+  PrintHeader("GeometryParser::ConstructGeometry()", "vol");
+  for (long n = 10; n <= opt.maxVolumes; n *= 10) {
+    const json config = SyntheticGeometry(n, "");
+    std::vector<Measurement> runs;
+    for (int r = 0; r < opt.repeat; r++) {
+      GeometryParser parser;
+      parser.LoadGeometryConfig(config, "synthetic.json");
+      Stopwatch watch;
+      watch.Start();
+      parser.ConstructGeometry();
+      watch.Stop();
+      runs.push_back(watch.Result());
+
+      G4PhysicalVolumeStore::Clean();
+      G4LogicalVolumeStore::Clean();
+      G4SolidStore::Clean();
+      parser.ClearGeometry();
+    }
+    Report("geometry", std::to_string(n) + " volumes", n, 0, Best(runs));
+  }
+}
+
+/**
+ * @brief ProcessHits() of a sensitive detector type on synthetic steps
+ * @param type Type name of the SensitiveDetectorFactory
+ */
+void BenchProcessHits(const Options& opt, const std::string& type, G4VSensitiveDetector* sd,
+                      const std::vector<StepInput>& steps)
+{
+  PrintHeader("ProcessHits() - " + type, "hit");
+  SyntheticStep step;
+  for (long perEvent : {100L, 10000L}) {
+    const long nEvents = std::max(1L, opt.hitsPerCase / perEvent);
+    std::vector<Measurement> runs;
+    for (int r = 0; r < opt.repeat; r++) {
+      Stopwatch watch;
+      for (long e = 0; e < nEvents; e++) {
+        delete RecordHits(sd, steps, e * perEvent, perEvent, step, &watch);
+      }
+      runs.push_back(watch.Result());
+    }
+    Report("hits_" + type, std::to_string(perEvent) + " hits/event", nEvents * perEvent, nEvents, Best(runs));
+  }
+}
+
+/**
+ * @brief EventAction::EndOfEventAction() per mode and hit multiplicity, and the file write
+ * @details Every repetition is a run of its own: RunAction opens the output file at the
+ *          start and writes and closes it at the end, which is timed as the root case.
+ */
+void BenchEventAction(const Options& opt, G4RunManager* runManager, EventAction* eventAction,
+                      MySensitiveDetector* sd, const std::vector<StepInput>& steps)
+{
+  SyntheticStep step;
+  for (G4int mode : {0, 1}) {
+    EventAction::SetSummarize(mode);
+    const std::string modeName = mode ? "summary" : "detailed";
+    PrintHeader("EventAction::EndOfEventAction() - " + modeName, "hit");
+
+    std::vector<Row> writes;
+    for (long perEvent : {1L, 10L, 100L, 1000L, 10000L}) {
+      const long nEvents = std::max(20L, opt.hitsPerCase / perEvent);
+      std::vector<Measurement> runs, closes;
+      std::uintmax_t fileBytes = 0;
+      for (int r = 0; r < opt.repeat; r++) {
+        runManager->RunInitialization();
+        Stopwatch watch;
+        for (long e = 0; e < nEvents; e++) {
+          G4Event event(static_cast<G4int>(e));
+          event.SetHCofThisEvent(RecordHits(sd, steps, e * perEvent, perEvent, step, nullptr));
+          watch.Start();
+          eventAction->EndOfEventAction(&event);
+          watch.Stop();
+        }
+        Stopwatch close;
+        close.Start();
+        runManager->RunTermination();
+        close.Stop();
+        runs.push_back(watch.Result());
+        closes.push_back(close.Result());
+
+        std::error_code error;
+        fileBytes = std::filesystem::file_size(opt.rootFile, error);
+      }
+      const std::string variant = std::to_string(perEvent) + " hits/event";
+      Report("event_" + modeName, variant, nEvents * perEvent, nEvents, Best(runs));
+      writes.push_back({"root_" + modeName, variant + ", " + std::to_string(fileBytes / 1024) + " kB",
+                        static_cast<double>(nEvents * perEvent), 0., Best(closes)});
+    }
+
+    PrintHeader("RunAction::EndOfRunAction() file write - " + modeName, "hit");
+    for (const Row& row : writes) Report(row.bench, row.variant, row.units, row.events, row.m);
+  }
+  EventAction::SetSummarize(0);
+}
+
+/// Write the results as CSV
+void WriteCsv(const std::string& fileName)
+{
+  std::ofstream csv(fileName, std::ios::trunc);
+  if (!csv) {
+    std::cerr << "G4sim_bench - Error: cannot write " << fileName << std::endl;
+    return;
+  }
+  csv << "bench,case,items,events,seconds,allocations,bytes\n";
+  for (const Row& row : gRows) {
+    csv << row.bench << ",\"" << row.variant << "\"," << static_cast<long>(row.units) << ','
+        << static_cast<long>(row.events) << ',' << std::setprecision(9) << row.m.seconds << ','
+        << row.m.allocations << ',' << row.m.bytes << '\n';
+  }
+}
+
+void PrintUsage(std::ostream& out)
+{
+  out << "Usage: G4sim_bench [--repeat <N>] [--max-volumes <N>] [--hits <N>] [--csv <file>] [--output <file>]\n"
+      << "  --repeat <N>       Repetitions per case, the fastest is reported (default 3)\n"
+      << "  --max-volumes <N>  Largest synthetic geometry (default 100000)\n"
+      << "  --hits <N>         Hits per event case and repetition (default 200000)\n"
+      << "  --csv <file>       Also write the results as CSV\n"
+      << "  --output <file>    ROOT file written by the event cases (default G4sim_bench.root, removed)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage(std::cout);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      PrintUsage(std::cerr);
+      return 1;
+    }
+    const std::string value = argv[++i];
+    if (arg == "--repeat") opt.repeat = std::max(1, std::atoi(value.c_str()));
+    else if (arg == "--max-volumes") opt.maxVolumes = std::atol(value.c_str());
+    else if (arg == "--hits") opt.hitsPerCase = std::max(1L, std::atol(value.c_str()));
+    else if (arg == "--csv") opt.csvFile = value;
+    else if (arg == "--output") opt.rootFile = value;
+    else {
+      PrintUsage(std::cerr);
+      return 1;
+    }
+  }
+
+  auto* runManager = new G4RunManager();
+
+  // The code under test is chatty; keep the terminal for the results
+  std::ostream report(std::cout.rdbuf());
+  gReport = &report;
+  NullBuffer nullBuffer;
+  std::cout.rdbuf(&nullBuffer);
+  QuietDestination quiet;
+  G4iosSetDestination(&quiet);
+
+  BenchGeometry(opt);
+
+  // Detector, physics and the repo's run and event actions
+  runManager->SetUserInitialization(new BenchDetectorConstruction());
+  runManager->SetUserInitialization(new BenchPhysicsList());
+  auto* runAction = new RunAction();
+  runAction->SetOutputFileName(opt.rootFile);
+  auto* eventAction = new EventAction();
+  runManager->SetUserAction(runAction);
+  runManager->SetUserAction(eventAction);
+  runManager->Initialize();
+
+  auto* sd = dynamic_cast<MySensitiveDetector*>(
+      G4SDManager::GetSDMpointer()->FindSensitiveDetector(G4String(kCollection) + "_SD", false));
+  G4VPhysicalVolume* world = G4PhysicalVolumeStore::GetInstance()->GetVolume("World", false);
+  if (!sd || !world) {
+    std::cerr << "G4sim_bench - Error: bench detector not built" << std::endl;
+    return 1;
+  }
+  const std::vector<StepInput> steps = SyntheticSteps(world, 1 << 16);
+
+  BenchProcessHits(opt, SensitiveDetectorFactory::DefaultType, sd, steps);
+  for (const G4String& type : SensitiveDetectorFactory::Types()) {
+    if (type == SensitiveDetectorFactory::DefaultType) continue;
+    // Not attached to the geometry: only ProcessHits() is measured
+    std::unique_ptr<G4VSensitiveDetector> scorer(
+        SensitiveDetectorFactory::Create(type, "bench_" + type, "bench_" + type));
+    BenchProcessHits(opt, type, scorer.get(), steps);
+  }
+  BenchEventAction(opt, runManager, eventAction, sd, steps);
+
+  delete runManager;
+  std::filesystem::remove(opt.rootFile);
+  if (!opt.csvFile.empty()) WriteCsv(opt.csvFile);
+
+  G4iosSetDestination(nullptr);
+  std::cout.rdbuf(report.rdbuf());
+  return 0;
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Check that runs split over processes read disjoint events of an event file.
+
+Writes a small binary event file, then runs two /run/beamOn in one G4sim job
+with --processes 2 and /source/type file.  Every child logs the range of input
+events it reads; the ranges of both runs must not overlap and together must
+cover the first events of the file without gaps.
+
+Usage (from anywhere; G4sim runs in the project directory):
+
+  bench/check_forked_event_file.py [--g4sim build/G4sim] [--keep]
+
+The exit code is 1 if the ranges overlap or leave gaps, 2 if G4sim failed.
+"""
+
+import argparse
+import re
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+BENCH_DIR = Path(__file__).resolve().parent
+PROJECT_DIR = BENCH_DIR.parent
+DEFAULT_G4SIM = PROJECT_DIR / "build" / "G4sim"
+GEOMETRY = "bench/scenarios/gamma_detector.json"
+
+PROCESSES = 2
+EVENTS_PER_RUN = 10
+RUNS = 2
+FILE_EVENTS = 4 * EVENTS_PER_RUN
+
+RANGE_LINE = re.compile(r"Process (\d+) reads events \[(\d+), (\d+)\)")
+
+
+def write_event_file(path: Path, n_events: int) -> None:
+    """One 100 keV gamma at the origin per event, in the phase-space format."""
+    with open(path, "wb") as f:
+        f.write(b"G4SIMPS1" + struct.pack("<IIQ", 1, 48, n_events))
+        for event in range(n_events):
+            f.write(struct.pack("<ii7fdf", event, 22, 0.1, 0, 0, 0, 0, 0, 1, 0.0, 1.0))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--g4sim", type=Path, default=DEFAULT_G4SIM, help="G4sim executable")
+    parser.add_argument("--keep", action="store_true", help="keep the work directory (log, output)")
+    args = parser.parse_args()
+
+    if not args.g4sim.is_file():
+        print(f"G4sim executable not found: {args.g4sim}", file=sys.stderr)
+        return 2
+
+    work_dir = Path(tempfile.mkdtemp(prefix="g4sim_forked_file_"))
+    input_file = work_dir / "input.bin"
+    write_event_file(input_file, FILE_EVENTS)
+
+    macro = work_dir / "run.mac"
+    macro.write_text(
+        f"/detector/setGeometryFile {GEOMETRY}\n"
+        f"/output/setFileName {work_dir / 'output.root'}\n"
+        "/run/initialize\n"
+        "/source/type file\n"
+        f"/source/file/name {input_file}\n"
+        + f"/run/beamOn {EVENTS_PER_RUN}\n" * RUNS
+    )
+
+    log_file = work_dir / "G4sim.log"
+    with open(log_file, "w") as log:
+        result = subprocess.run(
+            [str(args.g4sim.resolve()), "--headless", "--processes", str(PROCESSES), str(macro)],
+            cwd=PROJECT_DIR, stdout=log, stderr=subprocess.STDOUT,
+        )
+    if result.returncode != 0:
+        print(f"G4sim failed (exit code {result.returncode}), see {log_file}", file=sys.stderr)
+        return 2
+
+    ranges = sorted((int(m[2]), int(m[3])) for m in RANGE_LINE.finditer(log_file.read_text()))
+    print(f"Ranges read: {ranges}")
+
+    ok = len(ranges) == PROCESSES * RUNS
+    if not ok:
+        print(f"Expected {PROCESSES * RUNS} ranges, found {len(ranges)}", file=sys.stderr)
+    position = 0
+    for begin, end in ranges:
+        if begin < position:
+            print(f"Range [{begin}, {end}) overlaps events read before", file=sys.stderr)
+            ok = False
+        elif begin > position:
+            print(f"Events [{position}, {begin}) were skipped", file=sys.stderr)
+            ok = False
+        position = max(position, end)
+    if position != RUNS * EVENTS_PER_RUN:
+        print(f"Events [0, {position}) read, expected [0, {RUNS * EVENTS_PER_RUN})", file=sys.stderr)
+        ok = False
+
+    if args.keep or not ok:
+        print(f"Work directory kept: {work_dir}")
+    else:
+        shutil.rmtree(work_dir, ignore_errors=True)
+    print("OK: the runs read disjoint events" if ok else "FAILED")
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""
+End-to-end throughput regression harness — runs the reference scenarios of
+bench/scenarios.json with G4sim and compares them against a stored baseline.
+
+Each scenario is a batch macro with a fixed master seed and event count.  For
+every run the harness records:
+
+  events_per_second       event-loop throughput (from the G4sim progress file)
+  startup_s               launch until the first run starts (initialisation and
+                          physics tables)
+  peak_rss_bytes          peak resident memory of the G4sim process
+  output_bytes_per_event  size of the ROOT output file per event
+
+Usage (from anywhere; G4sim runs in the project directory):
+
+  bench/run_benchmarks.py                        # run, compare with bench/baseline.json
+  bench/run_benchmarks.py --update-baseline      # run and store the result as baseline
+  bench/run_benchmarks.py --scenario gamma_detector --repeat 3
+
+The exit code is 1 if a metric is worse than its baseline by more than the
+tolerance, 2 if a scenario failed to run.
+"""
+
+import argparse
+import json
+import os
+import platform
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+from datetime import datetime
+from pathlib import Path
+
+BENCH_DIR = Path(__file__).resolve().parent
+PROJECT_DIR = BENCH_DIR.parent
+SCENARIOS_FILE = BENCH_DIR / "scenarios.json"
+DEFAULT_BASELINE = BENCH_DIR / "baseline.json"
+DEFAULT_G4SIM = PROJECT_DIR / "build" / "G4sim"
+
+# Metric -> True if larger values are better
+METRICS = {
+    "events_per_second": True,
+    "startup_s": False,
+    "peak_rss_bytes": False,
+    "output_bytes_per_event": False,
+}
+
+POLL_INTERVAL = 0.02  # seconds between checks for the progress file
+
+
+def read_json(path: Path) -> dict | None:
+    """Load a JSON file, or None if it is absent or incomplete."""
+    try:
+        return json.loads(path.read_text())
+    except (OSError, ValueError):
+        return None
+
+
+def run_scenario(g4sim: Path, scenario: dict, work_dir: Path, timeout: float) -> dict:
+    """Run one scenario once and return its metrics."""
+    progress_file = work_dir / "progress.json"
+    output_file = work_dir / "output.root"
+    log_file = work_dir / "G4sim.log"
+    for path in (progress_file, output_file):
+        path.unlink(missing_ok=True)
+
+    # Redirect the output, then run the scenario macro unchanged
+    macro = work_dir / "run.mac"
+    macro.write_text(
+        f"/output/setFileName {output_file}\n"
+        f"/control/execute {scenario['macro']}\n"
+    )
+
+    cmd = [str(g4sim), "--headless", "--progress-file", str(progress_file)]
+    if scenario.get("physics"):
+        cmd += ["--physics", scenario["physics"]]
+    cmd.append(str(macro))
+
+    start = time.monotonic()
+    startup = None
+    with open(log_file, "w") as log:
+        proc = subprocess.Popen(cmd, cwd=PROJECT_DIR, stdout=log, stderr=subprocess.STDOUT)
+        while True:
+            # wait4 gives the resource usage of this child alone
+            pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+            if pid:
+                break
+            now = time.monotonic()
+            if startup is None and progress_file.exists():
+                startup = now - start
+            if now - start > timeout:
+                proc.send_signal(signal.SIGKILL)
+            time.sleep(POLL_INTERVAL)
+    wall = time.monotonic() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    progress = read_json(progress_file)
+    if proc.returncode != 0 or not progress or progress.get("status") != "finished":
+        raise RuntimeError(
+            f"{scenario['name']}: G4sim failed (exit code {proc.returncode}), see {log_file}"
+        )
+
+    events = progress["events_done"]
+    output_bytes = output_file.stat().st_size if output_file.exists() else 0
+    return {
+        "events": events,
+        "events_per_second": progress["events_per_second"],
+        "startup_s": startup if startup is not None else wall - progress["elapsed_s"],
+        "peak_rss_bytes": usage.ru_maxrss * 1024,  # kilobytes on Linux
+        "output_bytes_per_event": output_bytes / events if events else 0.0,
+        "wall_s": wall,
+    }
+
+
+def best_of(runs: list[dict]) -> dict:
+    """Best value of every metric over the repetitions (least disturbed)."""
+    best = dict(runs[0])
+    for metric, higher_is_better in METRICS.items():
+        values = [run[metric] for run in runs]
+        best[metric] = max(values) if higher_is_better else min(values)
+    best["wall_s"] = min(run["wall_s"] for run in runs)
+    return best
+
+
+def tolerance(config: dict, scenario: dict, metric: str) -> float:
+    """Relative tolerance of a metric: per scenario, else global."""
+    return scenario.get("tolerances", {}).get(metric, config.get("tolerances", {}).get(metric, 0.10))
+
+
+def compare(config: dict, results: dict, baseline: dict) -> bool:
+    """Print the comparison table; return True if nothing regressed."""
+    ok = True
+    print(f"\n{'scenario':<18} {'metric':<24} {'baseline':>14} {'current':>14} {'change':>9}  status")
+    for scenario in config["scenarios"]:
+        name = scenario["name"]
+        current = results["scenarios"].get(name)
+        reference = baseline.get("scenarios", {}).get(name)
+        if current is None:
+            continue
+        if reference is None:
+            print(f"{name:<18} {'(not in baseline)':<24}")
+            continue
+        for metric, higher_is_better in METRICS.items():
+            base, value = reference.get(metric), current[metric]
+            if not base:
+                continue
+            change = (value - base) / base
+            worse = -change if higher_is_better else change
+            limit = tolerance(config, scenario, metric)
+            if worse > limit:
+                status = f"REGRESSION (> {limit:.0%})"
+                ok = False
+            elif worse < -limit:
+                status = "improved"
+            else:
+                status = "ok"
+            print(f"{name:<18} {metric:<24} {base:>14.6g} {value:>14.6g} {change:>+8.1%}  {status}")
+    return ok
+
+
+def git_commit() -> str | None:
+    """Commit of the working tree, if it is a git checkout."""
+    try:
+        return subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"], cwd=PROJECT_DIR,
+            capture_output=True, text=True, check=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--g4sim", type=Path, default=DEFAULT_G4SIM, help="G4sim executable")
+    parser.add_argument("--scenario", action="append", help="run only this scenario (repeatable)")
+    parser.add_argument("--repeat", type=int, default=1, help="runs per scenario, the best is kept")
+    parser.add_argument("--results", type=Path, default=Path("bench_results.json"),
+                        help="results file to write (default bench_results.json)")
+    parser.add_argument("--baseline", type=Path, default=DEFAULT_BASELINE, help="baseline to compare with")
+    parser.add_argument("--update-baseline", action="store_true", help="store the results as the new baseline")
+    parser.add_argument("--timeout", type=float, default=3600, help="seconds before a run is killed")
+    parser.add_argument("--keep", action="store_true", help="keep the work directory (logs, output)")
+    args = parser.parse_args()
+
+    if not args.g4sim.is_file():
+        print(f"G4sim executable not found: {args.g4sim}", file=sys.stderr)
+        return 2
+
+    config = read_json(SCENARIOS_FILE)
+    scenarios = [s for s in config["scenarios"] if not args.scenario or s["name"] in args.scenario]
+    if not scenarios:
+        print("No scenario selected", file=sys.stderr)
+        return 2
+
+    results = {
+        "created": datetime.now().isoformat(timespec="seconds"),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "cpus": os.cpu_count(),
+        "commit": git_commit(),
+        "g4sim": str(args.g4sim.resolve()),
+        "repeat": args.repeat,
+        "scenarios": {},
+    }
+
+    work_dir = Path(tempfile.mkdtemp(prefix="g4sim_bench_"))
+    failed = False
+    for scenario in scenarios:
+        scenario_dir = work_dir / scenario["name"]
+        scenario_dir.mkdir()
+        runs = []
+        try:
+            for i in range(max(1, args.repeat)):
+                print(f"{scenario['name']}: run {i + 1}/{args.repeat} ...", flush=True)
+                runs.append(run_scenario(args.g4sim.resolve(), scenario, scenario_dir, args.timeout))
+        except RuntimeError as e:
+            print(e, file=sys.stderr)
+            failed = True
+            continue
+        best = best_of(runs)
+        results["scenarios"][scenario["name"]] = best
+        print(
+            f"{scenario['name']}: {best['events_per_second']:.1f} events/s, "
+            f"startup {best['startup_s']:.1f} s, peak RSS {best['peak_rss_bytes'] / 2**20:.0f} MiB, "
+            f"{best['output_bytes_per_event']:.0f} B/event"
+        )
+
+    args.results.write_text(json.dumps(results, indent=2) + "\n")
+    print(f"\nResults written to {args.results}")
+    if args.keep or failed:
+        print(f"Work directory kept: {work_dir}")
+    else:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+    ok = True
+    if args.update_baseline:
+        args.baseline.write_text(json.dumps(results, indent=2) + "\n")
+        print(f"Baseline written to {args.baseline}")
+    else:
+        baseline = read_json(args.baseline)
+        if baseline is None:
+            print(f"No baseline at {args.baseline}; create one with --update-baseline")
+        else:
+            ok = compare(config, results, baseline)
+
+    if failed:
+        return 2
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#ifndef ConfinementSampler_h
+#define ConfinementSampler_h 1
+
+#include "G4AffineTransform.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4VSolid;
+
+/**
+ * @class ConfinementSampler
+ * @brief Fast uniform source positions inside (or on) named physical volumes
+ *
+ * GPS confinement (/gps/pos/confine) samples the GPS shape and asks the
+ * navigator whether each point lies in the volume, so thin or small volumes
+ * reject almost every sample.  This sampler instead works in the frame of each
+ * placement of the volume: points are drawn in the solid's bounding box and
+ * tested with G4VSolid::Inside against the solid and its daughters only, then
+ * transformed to world coordinates.  In surface mode points come from
+ * G4VSolid::GetPointOnSurface without any rejection.
+ *
+ * Optionally a table of accepted points is built once per run and events draw
+ * from it.  The settings are shared; each PrimaryGeneratorAction owns a sampler.
+ */
+class ConfinementSampler
+{
+  public:
+    ConfinementSampler();
+    ~ConfinementSampler();
+
+    /// Add a physical volume (all its placements) to sample in
+    static void AddVolume(const G4String& name) { fVolumeNames.push_back(name); fGeneration++; }
+
+    /// Stop confining the source
+    static void Clear() { fVolumeNames.clear(); fGeneration++; }
+
+    /// Sample on the surface instead of inside the volume
+    static void SetSurface(G4bool surface) { fSurface = surface; fGeneration++; }
+
+    /// Size of the table of pre-sampled points (0 = sample every event)
+    static void SetCacheSize(G4int size) { fCacheSize = size; fGeneration++; }
+
+    /// True if any volume is set
+    static G4bool IsActive() { return !fVolumeNames.empty(); }
+
+    /**
+     * @brief Draw a point
+     * @param point Sampled point in world coordinates
+     * @return False if no point could be found
+     */
+    G4bool Sample(G4ThreeVector& point);
+
+  private:
+    /** @brief One placement of a confining volume */
+    struct Placement {
+        const G4VPhysicalVolume* volume;                ///< The placed volume
+        G4AffineTransform toWorld;                      ///< Local to world transform
+        std::vector<const G4VSolid*> daughters;         ///< Daughter solids to exclude
+        std::vector<G4AffineTransform> toDaughter;      ///< Local to daughter transforms
+        G4ThreeVector boxMin;                           ///< Local bounding box
+        G4ThreeVector boxMax;
+        G4double weight;                                ///< Cumulative selection weight
+    };
+
+    /** @brief Find the placements of the named volumes in the current geometry */
+    void FindPlacements();
+
+    /** @brief Draw a point without the cache */
+    G4bool SampleDirect(G4ThreeVector& point) const;
+
+    std::vector<Placement> fPlacements;     ///< Placements of the confining volumes
+    std::vector<G4ThreeVector> fCache;      ///< Pre-sampled points
+    G4int fRunID = -1;                      ///< Run the placements were found for
+    G4int fSetupGeneration = -1;            ///< Settings the placements were found for
+
+    static std::vector<G4String> fVolumeNames;  ///< Confining physical volumes
+    static G4bool fSurface;                     ///< Surface instead of volume sampling
+    static G4int  fCacheSize;                   ///< Number of pre-sampled points
+    static G4int  fGeneration;                  ///< Incremented on every settings change
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef DecayWindow_h
+#define DecayWindow_h 1
+
+#include "G4VUserEventInformation.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <map>
+#include <utility>
+
+class G4Event;
+class G4Track;
+class G4ParticleDefinition;
+
+/**
+ * @class DecayEventInformation
+ * @brief Event information of an event started from deferred decay products
+ *
+ * The time offset is the global time of the first deferred decay, measured
+ * from the start of the event in which the decay chain began (the origin event).
+ * Times inside the event are relative to this offset.
+ */
+class DecayEventInformation : public G4VUserEventInformation
+{
+  public:
+    DecayEventInformation(G4double timeOffset, G4long originEvent)
+    : fTimeOffset(timeOffset), fOriginEvent(originEvent) {}
+
+    void Print() const override;
+
+    G4double GetTimeOffset() const  { return fTimeOffset; }
+    G4long   GetOriginEvent() const { return fOriginEvent; }
+
+  private:
+    G4double fTimeOffset;   ///< Offset of the event times within the chain
+    G4long   fOriginEvent;  ///< Global number of the event in which the decay chain started
+};
+
+/**
+ * @class DecayWindow
+ * @brief Splits radioactive decay chains into events of one coincidence window
+ *
+ * RunAction forces every isotope to decay within the event, so a single
+ * Th/U chain can span millions of years.  With a window set
+ * (/decay/setTimeWindow) StackingAction hands every radioactive-decay product
+ * created later than the window to Defer(); instead of being tracked it is
+ * queued.  PrimaryGeneratorAction starts the next event from the queue: the
+ * earliest deferred product and all others of the same chain within one
+ * window become the primaries, with times relative to the first of them.
+ * The source is only used when no deferred products are pending.
+ *
+ * The configuration is shared; the queue belongs to the worker thread.
+ */
+class DecayWindow
+{
+  public:
+    /** @brief Create the /decay/ messenger (once) */
+    static void CreateMessenger();
+
+    /// Set the coincidence window; 0 disables decay windowing
+    static void SetTimeWindow(G4double window) { fTimeWindow = window; }
+
+    /// Coincidence window (0 = off)
+    static G4double GetTimeWindow() { return fTimeWindow; }
+
+    /// True if decay windowing is switched on
+    static G4bool IsEnabled() { return fTimeWindow > 0; }
+
+    /** @brief Queue of the calling thread */
+    static DecayWindow* Instance();
+
+    /**
+     * @brief Defer a new track to a later event if it is a late decay product
+     * @param track Track about to be stacked
+     * @return True if the track was queued and must not be tracked now
+     */
+    G4bool Defer(const G4Track* track);
+
+    /**
+     * @brief Fill an event with the next group of deferred tracks
+     * @param event Event to add the primaries to
+     * @return False if nothing was pending
+     */
+    G4bool GeneratePrimaries(G4Event* event);
+
+    /// Number of deferred tracks not yet simulated
+    size_t Pending() const { return fQueue.size(); }
+
+    /** @brief Drop all deferred tracks, reporting how many were left */
+    void Clear();
+
+  private:
+    DecayWindow() = default;
+
+    /** @brief A decay product waiting for its own event */
+    struct DeferredTrack {
+        const G4ParticleDefinition* particle;   ///< Particle (ions include their excitation)
+        G4ThreeVector momentum;                  ///< Momentum
+        G4ThreeVector polarization;              ///< Polarization
+        G4ThreeVector position;                  ///< Creation point
+        G4double weight;                         ///< Track weight
+    };
+
+    /// Deferred tracks ordered by origin event, then by time within the chain
+    std::multimap<std::pair<G4long, G4double>, DeferredTrack> fQueue;
+
+    static G4double fTimeWindow;                 ///< Coincidence window (0 = off)
+    static G4ThreadLocal DecayWindow* fInstance; ///< Queue of this thread
+
+    class DecayMessenger;
+    static DecayMessenger* fMessenger;
+    static bool fMessengerCreated;               ///< Ensures messenger is created once
+};
+
+#endif
@@ -8,6 +8,8 @@
 #include "G4UIcmdWithAString.hh"
 #include <string>
 
+class GeometrySweep;
+
 /**
  * @class DetectorConstruction
  * @brief Constructs the detector geometry from JSON configuration files
@@ -63,12 +65,27 @@ class DetectorConstruction : public G4VUserDetectorConstruction
      */
     G4bool RebuildGeometry();
 
+    /**
+     * @brief Rebuild the geometry from an already parsed configuration
+     * @param config Geometry configuration; external files are resolved relative to the geometry file
+     * @return true if rebuild was successful, false otherwise
+     */
+    G4bool RebuildGeometry(const json& config);
+
+    /**
+     * @brief Print the navigation report of the current geometry
+     * @param minDaughters Only list mother volumes with at least this many daughters
+     */
+    void ReportNavigation(G4int minDaughters) const { parser.ReportNavigation(minDaughters); }
+
   private:
     class DetectorMessenger;
     DetectorMessenger* fMessenger;   ///< Messenger for UI commands
     
     GeometryParser parser;           ///< Parser for JSON configuration
     std::string geometryFile;        ///< Path to geometry config file
+    json pendingConfig;              ///< Configuration for the next Construct() (null: read geometryFile)
+    GeometrySweep* fSweep;           ///< Geometry variant sweep (/detector/sweep/)
     //std::string materialsFile;       ///< Path to materials config file
     //G4LogicalVolume* lXeVolume;      ///< Pointer to LXe volume for scoring
 };
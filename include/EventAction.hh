@@ -14,6 +14,7 @@ class G4Event;
 class TTree;
 class G4UIcmdWithAnInteger;
 class G4UIdirectory;
+class VolumeScoringSD;
 
 /**
  * @class EventAction
@@ -24,13 +25,25 @@ class G4UIdirectory;
  *
  * Two output modes are available (controlled via /output/setSummarize):
  *   - **Detailed** (default, 0): one entry per hit
- *     - <det>_nHits, <det>_x/y/z, <det>_E, <det>_volName
+ *     - <det>_nHits, <det>_x/y/z, <det>_E, <det>_w, <det>_volName
  *   - **Summarised** (1): one entry per unique volume per event
  *     - <det>_nHits  = number of volumes hit
  *     - <det>_E      = summed energy deposit per volume  [MeV]
  *     - <det>_x/y/z  = energy-weighted average position  [mm]
+ *     - <det>_w      = energy-weighted average track weight
  *     - <det>_volName = unique volume name
  *     - <det>_nHitsPerVol = number of raw hits merged into each summary
+ *
+ * Detectors of the per-volume scoring types (calorimeter, counter, timing;
+ * see SensitiveDetectorFactory) create no hits and fill their own branches
+ * (see VolumeScoringSD); they are not affected by the summarisation mode.
+ *
+ * Every event also gets eventID, its number within the whole run (the event
+ * ID plus the first event of this job or process; see EventSeeder), and
+ * timeOffset [ns] and originEvent: for events started from decay products
+ * deferred by the DecayWindow, the time of the event within its decay chain
+ * and the eventID of the event in which the chain began (0 and the event's
+ * own eventID otherwise).
  */
 class EventAction : public G4UserEventAction {
 public:
@@ -50,20 +63,32 @@ private:
 
   /// Cache of hits collection IDs by name
   std::map<G4String, G4int> fHitsCollectionIDs;
+
+  /// Per-volume scoring detectors by detector key
+  std::map<std::string, VolumeScoringSD*> fScorers;
   bool fCollectionsInitialized;
 
   /// Pointer to the TTree owned by RunAction
   TTree* fTree;
 
+  /// Run whose tree the branches were created in (each run gets a new tree)
+  G4int fTreeRunID;
+
   // ---- Per-detector ROOT branch data ----
   std::map<std::string, Int_t>                    fNHits;
   std::map<std::string, std::vector<double>>      fX;
   std::map<std::string, std::vector<double>>      fY;
   std::map<std::string, std::vector<double>>      fZ;
   std::map<std::string, std::vector<double>>      fE;
+  std::map<std::string, std::vector<double>>      fW;
   std::map<std::string, std::vector<std::string>> fVolName;
   std::map<std::string, std::vector<int>>         fNHitsPerVol;
 
+  // ---- Per-event ROOT branch data ----
+  Long64_t fEventID;      ///< Event number within the whole run (see EventSeeder)
+  Double_t fTimeOffset;   ///< Time of the event within its decay chain [ns]
+  Long64_t fOriginEvent;  ///< Global number of the event in which the decay chain began
+
   // ---- Summarisation flag & messenger ----
   static G4int fSummarize;
 
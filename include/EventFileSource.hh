@@ -0,0 +1,97 @@
+#ifndef EventFileSource_h
+#define EventFileSource_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <string>
+#include <vector>
+
+class G4Event;
+
+/**
+ * @class EventFileSource
+ * @brief Primary generator that reads pre-generated events from a file
+ *
+ * Supported inputs:
+ * - binary:  phase-space files as written by PhaseSpaceWriter (G4SIMPS1);
+ *            consecutive records with the same event number form one event
+ * - hepmc3:  HepMC3 ASCII (Asciiv3); every status-1 particle becomes a primary
+ *            at the position of its production vertex
+ *
+ * The file is memory-mapped once and indexed by event; parsing then touches
+ * only the bytes of the event being generated.  Each worker thread reads its
+ * own contiguous range of events, so no event is used twice.  The mapping and
+ * the index are shared; the event cursor belongs to the instance.
+ *
+ * A run split over processes (SimRunManager) is read from a cursor kept by the
+ * parent: every child reads its share of the run's events from there, and the
+ * parent moves the cursor past the run when the children have finished.
+ */
+class EventFileSource
+{
+  public:
+    /** @brief Input formats */
+    enum Format { kAuto = 0, kBinary, kHepMC3 };
+
+    EventFileSource();
+    ~EventFileSource();
+
+    /// Set the input file
+    static void SetFileName(const G4String& name) { fFileName = name; }
+
+    /// Set the input format ("auto" detects it from the file header)
+    static void SetFormat(const G4String& format);
+
+    /**
+     * @brief Add the primaries of the next event in this thread's range
+     * @param event Event to add the primaries to
+     */
+    void GeneratePrimaries(G4Event* event);
+
+    /**
+     * @brief Move the input past the events of a run split over processes
+     * @param nEvents Events of the run
+     * @details Called by the parent process when its children have finished.
+     */
+    static void AdvanceForkedRun(G4int nEvents);
+
+  private:
+    /** @brief A memory-mapped, indexed input file */
+    struct MappedInput {
+        std::string name;               ///< File name
+        Format format = kAuto;          ///< Detected format
+        const char* data = nullptr;     ///< Mapped file contents
+        size_t size = 0;                ///< File size
+        std::vector<size_t> events;     ///< Start offset of every event, plus the file size
+    };
+
+    /** @brief Shared input for fFileName, mapped and indexed on first use */
+    static const MappedInput* Input();
+
+    /** @brief Map a file and build its event index; nullptr on error */
+    static MappedInput* Open(const std::string& name);
+
+    /** @brief Close a mapped input */
+    static void Close(MappedInput* input);
+
+    /** @brief Add the primaries of a binary event */
+    static void ReadBinaryEvent(const char* begin, const char* end, G4Event* event);
+
+    /** @brief Add the primaries of a HepMC3 ASCII event */
+    static void ReadHepMC3Event(const char* begin, const char* end, G4Event* event);
+
+    const MappedInput* fInput = nullptr;   ///< Input the cursor refers to
+    size_t fNext = 0;                      ///< Next event of this instance
+    size_t fEnd = 0;                       ///< End of this instance's event range
+    G4int fRunID = -1;                     ///< Run the range was set for
+
+    static std::string fForkedFile;        ///< Input the forked-run cursor refers to
+    static size_t fForkedCursor;           ///< First event of the next run split over processes
+
+    static G4String fFileName;             ///< File to read
+    static Format fFormat;                 ///< Requested format
+    static MappedInput* fShared;           ///< Mapped input shared by all threads
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+/**
+ * @class EventSeeder
+ * @brief Reproducible per-event random seeds and event ranges
+ *
+ * With a master seed set (/random/setMasterSeed or --seed), the engine is
+ * reseeded before every event from a hash of the master seed, the run ID and
+ * the global event number.  An event therefore gets the same random numbers
+ * however the run is split over processes, jobs or event ranges.
+ *
+ * The global event number is the event ID plus the first event of this job
+ * (/random/setFirstEvent or --first-event); --n-events overrides the number
+ * of events of every /run/beamOn.  Job j of a run split into jobs of N events
+ * each uses --first-event j*N --n-events N.
+ *
+ * Without a master seed the engine runs freely, as before.
+ */
+class EventSeeder
+{
+  public:
+    /** @brief Create the /random/ commands (once) */
+    static void CreateMessenger();
+
+    /// Set the master seed; 0 switches per-event seeding off
+    static void SetMasterSeed(G4long seed);
+
+    /// Number of the first event of this job
+    static void SetFirstEvent(G4long first);
+
+    /// Events of every /run/beamOn (negative = the macro's count)
+    static void SetNumberOfEvents(G4int n) { fNEvents = n; }
+
+    /// True if events are seeded individually
+    static G4bool IsActive() { return fMasterSeed != 0; }
+
+    /// Number of the first event of this job
+    static G4long GetFirstEvent() { return fFirstEvent; }
+
+    /// Global number of an event of the current run
+    static G4long GlobalEventID(G4int eventID) { return fFirstEvent + eventID; }
+
+    /**
+     * @brief Events to run for a /run/beamOn
+     * @param n Number of events requested by the macro
+     * @return n, or the --n-events override
+     */
+    static G4int NumberOfEvents(G4int n) { return (fNEvents >= 0) ? fNEvents : n; }
+
+    /**
+     * @brief Reseed the engine for an event
+     * @param runID Run the event belongs to
+     * @param eventID Event ID within the run
+     */
+    static void SeedEvent(G4int runID, G4int eventID);
+
+    /**
+     * @brief Reseed the engine for a per-run task outside the events
+     * @param runID Run the task belongs to
+     * @param stream Task number, so that tasks of one run get different seeds
+     * @details For work done once per run (e.g. a table of source points) that
+     *          must not depend on which event happens to trigger it.
+     */
+    static void SeedRunTask(G4int runID, uint64_t stream);
+
+  private:
+    /** @brief Set the engine seeds from a hash */
+    static void SetSeeds(uint64_t hash);
+
+    /** @brief 64-bit finaliser of SplitMix64 */
+    static uint64_t Mix(uint64_t x);
+
+    static G4long fMasterSeed;      ///< Master seed (0 = off)
+    static G4long fFirstEvent;      ///< Global number of event 0
+    static G4int  fNEvents;         ///< Events per /run/beamOn override (-1 = off)
+
+    class SeedMessenger;
+    static SeedMessenger* fMessenger;
+    static bool fMessengerCreated;  ///< Ensures messenger is created once
+};
+
+#endif
@@ -10,6 +10,9 @@
 #include "G4VSolid.hh"
 #include "G4VSensitiveDetector.hh"
 #include "G4AssemblyVolume.hh"
+#include "G4Transform3D.hh"
+#include "G4VisAttributes.hh"
+#include "G4VPVParameterisation.hh"
 #include <string>
 #include <map>
 #include <vector>
@@ -17,6 +20,9 @@
 
 using json = nlohmann::json;
 
+class G4Region;
+class G4ProductionCuts;
+
 /**
  * @class GeometryParser
  * @brief Parses JSON configuration files for geometry and materials
@@ -41,6 +47,21 @@ public:
      */
     void LoadGeometryConfig(const std::string& filename);
 
+    /**
+     * @brief Use an already parsed geometry configuration
+     * @param config Geometry configuration (e.g. a patched variant)
+     * @param filename Path the configuration belongs to; external files are resolved relative to it
+     */
+    void LoadGeometryConfig(const json& config, const std::string& filename);
+
+    /**
+     * @brief Read and parse a JSON file
+     * @param filename Path to the file
+     * @return Parsed JSON document
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    static json ReadJsonFile(const std::string& filename);
+
     /**
      * @brief Load materials configuration from JSON file
      * @param filename Path to materials JSON file
@@ -55,10 +76,79 @@ public:
     
     /**
      * @brief Setup sensitive detectors for active volumes
-     * @details This method assigns sensitive detectors to volumes marked as active in the JSON config
+     * @details This method assigns sensitive detectors to volumes marked as active in the JSON config,
+     *          of the type selected per hits collection (see SensitiveDetectorFactory)
+     * @throws std::runtime_error for an unknown type, or a collection used with two types
      */
     void SetupSensitiveDetectors();
 
+    /**
+     * @brief Create the regions listed under "regions" in the JSON config
+     * @details Each region gets its root volumes, optional per-particle production cuts
+     *          and optional G4UserLimits; existing regions of the same name are reused
+     */
+    void SetupRegions();
+
+    /**
+     * @brief Register the volumes flagged with "record_surface" in the JSON config
+     * @details Particles entering such a volume are written to a phase-space file
+     *          by the PhaseSpaceWriter; with {"kill": true} they are stopped as well
+     */
+    void SetupRecordSurfaces();
+
+    /**
+     * @brief Register the per-volume "importance" values for importance biasing
+     * @details The biased particles come from the top-level "importance_particles"
+     *          array (default neutron and gamma)
+     */
+    void SetupImportances();
+
+    /**
+     * @brief Print daughter counts and voxel statistics of mother volumes
+     * @param minDaughters Only list volumes with at least this many daughters
+     * @details Helps to find navigation hot spots; tune them with the per-volume
+     *          "smartless" and "optimise" JSON keys
+     */
+    void ReportNavigation(G4int minDaughters = 2) const;
+
+    /**
+     * @brief Check whether a geometry has been constructed
+     * @return true after ConstructGeometry() until ClearGeometry()
+     */
+    G4bool HasGeometry() const { return worldPhysical != nullptr; }
+
+    /**
+     * @brief Forget all geometry built so far and free the objects owned by the parser
+     * @details Call after the Geant4 volume and solid stores have been cleaned (e.g. by
+     *          G4RunManager::ReinitializeGeometry(true)).  Materials are kept so that a
+     *          rebuild does not define them twice.  The regions created by the parser are
+     *          deleted, so the next construction starts without their root volumes,
+     *          cuts and limits.
+     */
+    void ClearGeometry();
+
+    /**
+     * @brief Apply the differences between the loaded and a new geometry file in place
+     * @param filename Path to the new geometry JSON file
+     * @param materialsChanged Set to true if a logical volume changed material
+     * @return true if the changes were applied, false if a full rebuild is needed
+     * @throws std::runtime_error if the file cannot be opened or parsed
+     * @details Handles changes of placement positions and rotations, primitive solid
+     *          dimensions, materials and visualization settings.  Anything else (added or
+     *          removed volumes, new parents, assemblies, imports, patterns, redefined
+     *          materials) requires a full rebuild; nothing is modified in that case.
+     */
+    G4bool UpdateGeometry(const std::string& filename, G4bool& materialsChanged);
+
+    /**
+     * @brief Apply the differences to an already parsed configuration in place
+     * @param newConfig New geometry configuration
+     * @param filename Path the new configuration belongs to
+     * @param materialsChanged Set to true if a logical volume changed material
+     * @return true if the changes were applied, false if a full rebuild is needed
+     */
+    G4bool UpdateGeometry(const json& newConfig, const std::string& filename, G4bool& materialsChanged);
+
 private:
     json geometryConfig;    ///< Geometry configuration
     json materialsConfig;   ///< Materials configuration
@@ -68,8 +158,40 @@ private:
     std::map<std::string, G4LogicalVolume*> logicalVolumeMap;  ///< Map of logical volumes by name
     std::map<std::string, G4VSolid*> solids;           ///< Cache of created solids
     std::map<std::string, G4AssemblyVolume*> assemblies; ///< Cache of created assemblies
+
+    /** @brief Envelope volume built for an assembly in envelope mode */
+    struct AssemblyEnvelope {
+        G4LogicalVolume* logical = nullptr;   ///< Envelope logical volume holding the components
+        G4ThreeVector centre;                 ///< Envelope centre in the assembly frame
+    };
+    std::map<std::pair<std::string, G4Material*>, AssemblyEnvelope> assemblyEnvelopes; ///< Envelopes by assembly and fill material
     std::string configPath;                           ///< Path to the configuration files
 
+    G4VPhysicalVolume* worldPhysical = nullptr;       ///< World volume of the current geometry
+    std::map<std::pair<std::string, std::string>, int> copyNumbers; ///< Next copy number per (volume, parent)
+    std::map<std::string, std::vector<G4VPhysicalVolume*>> placementVolumes; ///< Physical volume of each placement, by volume name
+    std::vector<std::unique_ptr<G4RotationMatrix>> placementRotations; ///< Rotations of placed volumes (not owned by Geant4)
+    std::vector<std::unique_ptr<G4VisAttributes>> visAttributes;       ///< Visualization attributes of created volumes
+    std::vector<std::unique_ptr<G4VPVParameterisation>> parameterisations; ///< Parameterisations of pattern arrays
+    std::vector<G4Region*> regions;                   ///< Regions created for the current geometry
+    std::map<std::string, G4ProductionCuts*> regionCuts; ///< Production cuts by region name (kept: material-cuts couples refer to them)
+
+    /** @brief An external geometry file built once and placed as many times as needed */
+    struct ImportPrototype {
+        std::string path;                      ///< Resolved path of the external file
+        G4LogicalVolume* envelope = nullptr;   ///< Top-level volume placed for every instance
+        std::vector<json> volumeConfigs;       ///< Prefixed volume definitions (for sensitive detectors)
+    };
+    std::map<std::string, ImportPrototype> importPrototypes; ///< Built imports by name prefix
+    json importedMaterials;                           ///< Materials defined in imported files
+
+    /**
+     * @brief Look up the JSON definition of a material
+     * @param name Material name
+     * @return Definition from the main configuration or an imported file, empty object if unknown
+     */
+    json FindMaterialConfig(const std::string& name) const;
+
     /**
      * @brief Create a G4Material from JSON configuration
      * @param name Material name
@@ -218,13 +340,41 @@ private:
      * @param config JSON configuration for the assembly
      */
     void CreateAssembly(const json& config);
+
+    /**
+     * @brief Build (or reuse) the envelope mother volume of an assembly
+     * @param config JSON configuration for the assembly
+     * @param material Material filling the envelope (the material of the mother it is placed in)
+     * @param shape Envelope shape ("box" or "cylinder") used if the assembly does not set "envelope"
+     * @return Envelope logical volume and its centre in the assembly frame
+     * @details Components, including nested assemblies, become daughters of a tight envelope
+     *          instead of being flattened into the mother by G4AssemblyVolume imprints
+     */
+    const AssemblyEnvelope& BuildAssemblyEnvelope(const json& config, G4Material* material,
+                                                  const std::string& shape);
+
+    /**
+     * @brief Parse the transformation of an assembly placement
+     * @param placement JSON object with x, y, z and optional rotation
+     * @return Active transformation as used by G4AssemblyVolume::MakeImprint
+     */
+    G4Transform3D ParseAssemblyTransform(const json& placement);
     
     /**
-     * @brief Import an assembled geometry from an external file
+     * @brief Build the volumes of an external geometry file once
+     * @param config JSON configuration of the importing volume ("external_file", optional "name_prefix")
+     * @return Prototype whose envelope can be placed any number of times
+     * @throws std::runtime_error if the file cannot be loaded or the prefix is already used by another file
+     * @details Volume names are prefixed (default: file stem) so that imports never collide
+     *          with each other or with the main configuration
+     */
+    const ImportPrototype& BuildImportPrototype(const json& config);
+
+    /**
+     * @brief Place an imported geometry at every placement of the importing volume
      * @param config JSON configuration for the import
-     * @param motherVolume Logical volume to place the imported geometry in
      */
-    void ImportAssembledGeometry(const json& config, G4LogicalVolume* motherVolume);
+    void ImportAssembledGeometry(const json& config);
 
     /**
      * @brief Convert JSON vector to G4ThreeVector with units
@@ -249,6 +399,31 @@ private:
      * @details Handles the geometry-editor format with placements array
      */
     void ParsePlacement(const json& config, G4ThreeVector& position, G4RotationMatrix*& rotation);
+
+    /**
+     * @brief Generate the copy offsets of a placement pattern
+     * @param pattern JSON object with the pattern type (linear, grid, ring, hex) and parameters
+     * @param offsets Filled with the offset of each copy relative to the placement origin
+     * @param phis Filled with the extra rotation about z of each copy (rotated rings only)
+     * @throws std::runtime_error if the pattern type is unknown or parameters are invalid
+     */
+    void GeneratePatternOffsets(const json& pattern, std::vector<G4ThreeVector>& offsets,
+                                std::vector<G4double>& phis);
+
+    /**
+     * @brief Place all copies described by a placement with a "pattern" entry
+     * @param placement JSON placement object containing the pattern
+     * @param logicalVolume Logical volume to place
+     * @param placementName Base name for the physical volume(s)
+     * @param parentVolume Mother logical volume
+     * @param firstCopyNo Copy number of the first generated copy
+     * @return Number of copies placed
+     * @details Copies are placed individually, or as one G4PVParameterised if the
+     *          pattern sets "parameterised": true
+     */
+    int PlacePattern(const json& placement, G4LogicalVolume* logicalVolume,
+                     const std::string& placementName, G4LogicalVolume* parentVolume,
+                     int firstCopyNo);
 };
 
 #endif
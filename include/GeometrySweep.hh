@@ -0,0 +1,83 @@
+#ifndef GeometrySweep_h
+#define GeometrySweep_h 1
+
+#include "json.hpp"
+#include "globals.hh"
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+class DetectorConstruction;
+
+/**
+ * @class GeometrySweep
+ * @brief Runs a list of geometry variants in one process
+ *
+ * Variants are complete geometry JSON files or JSON patches of the current
+ * geometry file (RFC 6902 patch arrays or RFC 7386 merge-patch objects).
+ * Physics is initialised once; for every variant the geometry is rebuilt
+ * (in place where possible), N events are run and the output is written to
+ * <output>_<variant>.root with the variant name stored as tree metadata.
+ *
+ * Commands live under /detector/sweep/.
+ */
+class GeometrySweep
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param detector Detector construction whose geometry is varied
+     */
+    explicit GeometrySweep(DetectorConstruction* detector);
+
+    /** @brief Destructor */
+    ~GeometrySweep();
+
+    /**
+     * @brief Add a variant given by a complete geometry file
+     * @param filename Path to the geometry JSON file
+     */
+    void AddGeometry(const std::string& filename);
+
+    /**
+     * @brief Add a variant given by a patch of the current geometry file
+     * @param filename Path to a JSON file holding a patch array or merge-patch object
+     */
+    void AddPatch(const std::string& filename);
+
+    /** @brief Remove all variants */
+    void Clear() { fVariants.clear(); }
+
+    /** @brief Print the list of variants */
+    void List() const;
+
+    /**
+     * @brief Run every variant
+     * @param nEvents Number of events per variant
+     */
+    void Run(G4int nEvents);
+
+  private:
+    /** @brief One geometry variant */
+    struct Variant {
+        std::string label;   ///< Name used for the output file and metadata
+        std::string file;    ///< Geometry file or patch file
+        json patch;          ///< Patch (null for complete geometry files)
+    };
+
+    /**
+     * @brief Variant label from the file stem, made unique within the sweep
+     * @param filename Geometry or patch file of the variant
+     * @return Label for the new variant
+     */
+    std::string UniqueLabel(const std::string& filename) const;
+
+    class SweepMessenger;
+    SweepMessenger* fMessenger;          ///< Messenger for /detector/sweep/ commands
+
+    DetectorConstruction* fDetector;     ///< Detector construction whose geometry is varied
+    std::vector<Variant> fVariants;      ///< Variants in the order they were added
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ImportanceBiasing_h
+#define ImportanceBiasing_h 1
+
+#include "G4VPhysicsConstructor.hh"
+#include "globals.hh"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class G4GeometrySampler;
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+/**
+ * @class ImportanceBiasing
+ * @brief Geometry importance sampling (splitting / Russian roulette) from the geometry JSON
+ *
+ * Volumes carry an optional "importance" in the geometry JSON (default 1); the
+ * GeometryParser registers them here.  A particle crossing from importance i1
+ * into i2 is split into i2/i1 copies (i2 > i1) or survives Russian roulette
+ * with probability i2/i1 (i2 < i1); the track weight compensates.
+ *
+ * The constructor is always registered in the physics list.  When the geometry
+ * present at /run/initialize has importance values, ConstructProcess attaches a
+ * G4GeometrySampler to each biased particle (top-level "importance_particles",
+ * default neutron and gamma).  The G4IStore is refilled at the start of every run
+ * from the current geometry, so moved or resized volumes keep their importance.
+ */
+class ImportanceBiasing : public G4VPhysicsConstructor
+{
+  public:
+    ImportanceBiasing();
+    ~ImportanceBiasing() override;
+
+    /// Nothing to construct: only existing particles are biased
+    void ConstructParticle() override {}
+
+    /** @brief Attach the importance process to the biased particles */
+    void ConstructProcess() override;
+
+    /// Forget all importances and particles (the geometry is being rebuilt)
+    static void Clear() { fImportances.clear(); fParticles.clear(); }
+
+    /// Set the importance of every placement of a logical volume
+    static void SetImportance(const G4LogicalVolume* volume, G4double importance) { fImportances[volume] = importance; }
+
+    /// Bias this particle (only effective for the geometry at /run/initialize)
+    static void AddParticle(const G4String& name) { fParticles.push_back(name); }
+
+    /// True if any volume has an importance
+    static G4bool HasImportances() { return !fImportances.empty(); }
+
+    /** @brief Fill the importance store from the current geometry (called at the start of a run) */
+    static void BeginOfRun();
+
+  private:
+    std::vector<std::unique_ptr<G4GeometrySampler>> fSamplers;   ///< One sampler per biased particle
+
+    static G4bool fConfigured;                                        ///< Samplers were attached
+    static std::map<const G4LogicalVolume*, G4double> fImportances;   ///< Importance per logical volume
+    static std::vector<G4String> fParticles;                          ///< Biased particles
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef KillPolicy_h
+#define KillPolicy_h 1
+
+#include "globals.hh"
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+
+class G4Track;
+class G4Step;
+class G4Region;
+class G4ParticleDefinition;
+class G4VPhysicalVolume;
+
+/**
+ * @class KillPolicy
+ * @brief Macro-configurable rules for killing tracks that waste stepping time
+ *
+ * The rules are checked by StackingAction when a track is created and by
+ * SteppingAction after every step:
+ * - particle list: neutrinos (/kill/neutrinos) and any named particle (/kill/particle)
+ * - time window:   tracks beyond a global time (/kill/timeWindow)
+ * - low energy:    particles below a kinetic energy outside sensitive volumes (/kill/lowEnergy)
+ * - region:        tracks leaving a region of interest (/kill/regionOfInterest)
+ *
+ * All rules are off by default.  Killed tracks are counted per rule and the
+ * counts are printed at the end of every run.
+ */
+class KillPolicy
+{
+  public:
+    /** @brief Kill rules, in the order they are checked */
+    enum Rule { kParticle = 0, kTimeWindow, kLowEnergy, kRegion, kNRules };
+
+    /** @brief Create the /kill/ messenger (once) */
+    static void CreateMessenger();
+
+    /// Kill neutrinos as soon as they are created
+    static void SetKillNeutrinos(G4bool kill) { fKillNeutrinos = kill; }
+
+    /// Add a particle to the kill list (resolved at the start of the next run)
+    static void AddParticle(const G4String& name) { fParticleNames.insert(name); }
+
+    /// Kill tracks beyond this global time; 0 disables the rule
+    static void SetTimeWindow(G4double time) { fTimeWindow = time; }
+
+    /// Kill particles below this kinetic energy outside sensitive volumes; 0 disables the rule
+    static void SetLowEnergy(G4double energy) { fLowEnergy = energy; }
+
+    /// Kill tracks leaving this region; empty or "none" disables the rule
+    static void SetRegionOfInterest(const G4String& name) { fRegionName = (name == "none") ? "" : name; }
+
+    /** @brief Switch all rules off */
+    static void Reset();
+
+    /** @brief True if any rule has to be checked after each step */
+    static G4bool HasStepRules() { return fTimeWindow > 0 || fLowEnergy > 0 || fRegion != nullptr; }
+
+    /**
+     * @brief Rule that kills a new track, if any
+     * @param track Track about to be stacked
+     * @return Rule index, or -1 if the track is kept
+     */
+    static G4int CheckNewTrack(const G4Track* track);
+
+    /**
+     * @brief Rule that kills the track after this step, if any
+     * @param step Step just taken
+     * @return Rule index, or -1 if the track is kept
+     */
+    static G4int CheckStep(const G4Step* step);
+
+    /// Count a track killed by a rule
+    static void Count(G4int rule) { fCounters[rule]++; }
+
+    /** @brief Resolve particle and region names and reset the counters */
+    static void BeginOfRun();
+
+    /** @brief Print the active rules and the number of tracks each killed */
+    static void Report();
+
+    /**
+     * @brief Killed-track counts of the active rules
+     * @return Map of rule name to number of killed tracks
+     */
+    static std::map<std::string, G4long> Counters();
+
+  private:
+    /// Short name of a rule, used in the report and the output metadata
+    static const char* RuleName(G4int rule);
+
+    /// True if the rule is switched on
+    static G4bool IsActive(G4int rule);
+
+    /// True if the low-energy rule may kill this track here
+    static G4bool IsLowEnergyKill(const G4Track* track, G4double energy,
+                                  const G4VPhysicalVolume* volume);
+
+    static G4bool   fKillNeutrinos;                     ///< Kill neutrinos at creation
+    static std::set<G4String> fParticleNames;           ///< Extra particles to kill at creation
+    static std::set<const G4ParticleDefinition*> fParticles;  ///< Resolved kill list
+    static G4double fTimeWindow;                        ///< Global time limit (0 = off)
+    static G4double fLowEnergy;                         ///< Kinetic energy limit (0 = off)
+    static G4String fRegionName;                        ///< Region of interest ("" = off)
+    static G4Region* fRegion;                           ///< Resolved region of interest
+
+    static std::array<std::atomic<G4long>, kNRules> fCounters;  ///< Killed tracks per rule
+
+    class KillMessenger;
+    static KillMessenger* fMessenger;
+    static bool fMessengerCreated;                      ///< Ensures messenger is created once
+};
+
+#endif
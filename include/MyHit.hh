@@ -17,6 +17,7 @@
  * - Position
  * - Energy deposit
  * - Time
+ * - Track weight (differs from 1 with importance biasing or weighted sources)
  */
 class MyHit : public G4VHit {
 public:
@@ -37,6 +38,7 @@ public:
   void SetPosition(G4ThreeVector xyz) { fPosition = xyz; }
   void SetEnergy(G4double e) { fEnergy = e; }
   void SetTime(G4double t) { fTime = t; }
+  void SetWeight(G4double w) { fWeight = w; }
   
   // Getters
   G4int GetTrackID() const { return fTrackID; }
@@ -44,6 +46,7 @@ public:
   G4ThreeVector GetPosition() const { return fPosition; }
   G4double GetEnergy() const { return fEnergy; }
   G4double GetTime() const { return fTime; }
+  G4double GetWeight() const { return fWeight; }
   
 private:
   G4int fTrackID;
@@ -51,6 +54,7 @@ private:
   G4ThreeVector fPosition;
   G4double fEnergy;
   G4double fTime;
+  G4double fWeight;
 };
 
 // Define the hits collection type
@@ -0,0 +1,74 @@
+#ifndef PhaseSpaceRecord_h
+#define PhaseSpaceRecord_h 1
+
+#include "G4ThreeVector.hh"
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "globals.hh"
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @struct PhaseSpaceRecord
+ * @brief One particle crossing a record surface
+ *
+ * Phase-space files start with a 24-byte header
+ *   char[8] magic "G4SIMPS1", uint32 version, uint32 record size,
+ *   uint64 number of primary events simulated to produce the file,
+ * followed by fixed-size 48-byte records (native byte order):
+ *   int32 event, int32 PDG code, float energy [MeV], float x, y, z [mm],
+ *   float direction x, y, z, double time [ns], float weight.
+ */
+struct PhaseSpaceRecord
+{
+    G4int event = 0;            ///< Event that produced the particle
+    G4int pdg = 0;              ///< PDG encoding (ions: 100ZZZAAAI)
+    G4double energy = 0.;       ///< Kinetic energy
+    G4ThreeVector position;     ///< Crossing point (global coordinates)
+    G4ThreeVector direction;    ///< Momentum direction
+    G4double time = 0.;         ///< Global time
+    G4double weight = 1.;       ///< Track weight
+
+    static constexpr char     kMagic[8]   = {'G', '4', 'S', 'I', 'M', 'P', 'S', '1'};
+    static constexpr uint32_t kVersion    = 1;
+    static constexpr size_t   kHeaderSize = 24;
+    static constexpr size_t   kRecordSize = 48;
+
+    /** @brief Pack into the file layout */
+    void Pack(char* buffer) const
+    {
+        int32_t ints[2] = {event, pdg};
+        float floats[7] = {float(energy / CLHEP::MeV),
+                           float(position.x() / CLHEP::mm), float(position.y() / CLHEP::mm),
+                           float(position.z() / CLHEP::mm),
+                           float(direction.x()), float(direction.y()), float(direction.z())};
+        double t = time / CLHEP::ns;
+        float w = float(weight);
+        std::memcpy(buffer, ints, 8);
+        std::memcpy(buffer + 8, floats, 28);
+        std::memcpy(buffer + 36, &t, 8);
+        std::memcpy(buffer + 44, &w, 4);
+    }
+
+    /** @brief Unpack from the file layout */
+    void Unpack(const char* buffer)
+    {
+        int32_t ints[2];
+        float floats[7];
+        double t;
+        float w;
+        std::memcpy(ints, buffer, 8);
+        std::memcpy(floats, buffer + 8, 28);
+        std::memcpy(&t, buffer + 36, 8);
+        std::memcpy(&w, buffer + 44, 4);
+        event = ints[0];
+        pdg = ints[1];
+        energy = floats[0] * CLHEP::MeV;
+        position.set(floats[1] * CLHEP::mm, floats[2] * CLHEP::mm, floats[3] * CLHEP::mm);
+        direction.set(floats[4], floats[5], floats[6]);
+        time = t * CLHEP::ns;
+        weight = w;
+    }
+};
+
+#endif
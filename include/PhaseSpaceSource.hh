@@ -0,0 +1,81 @@
+#ifndef PhaseSpaceSource_h
+#define PhaseSpaceSource_h 1
+
+#include "PhaseSpaceRecord.hh"
+#include "globals.hh"
+
+#include <fstream>
+
+class G4Event;
+class G4ParticleDefinition;
+
+/**
+ * @class PhaseSpaceSource
+ * @brief Primary generator that replays a phase-space file
+ *
+ * Files written by PhaseSpaceWriter are replayed in one of two modes:
+ * - sequential: records are read in order and the records of one original
+ *   event become one event.  Worker threads and forked processes each replay
+ *   their own range of the file and start over at its end
+ * - random:     every event is one record drawn at random (resampling)
+ *
+ * With random phi every particle is additionally rotated about the z axis
+ * by a random angle, which decorrelates reused records for geometries that
+ * are symmetric about z.
+ *
+ * The settings are shared; each PrimaryGeneratorAction owns its own reader.
+ */
+class PhaseSpaceSource
+{
+  public:
+    PhaseSpaceSource();
+    ~PhaseSpaceSource();
+
+    /// Set the phase-space file to replay
+    static void SetFileName(const G4String& name) { fFileName = name; }
+
+    /// Draw records at random instead of reading them in order
+    static void SetRandom(G4bool random) { fRandom = random; }
+
+    /// Rotate every particle about the z axis by a random angle
+    static void SetRandomPhi(G4bool randomPhi) { fRandomPhi = randomPhi; }
+
+    /**
+     * @brief Add the next particle(s) from the file to the event
+     * @param event Event to add the primaries to
+     */
+    void GeneratePrimaries(G4Event* event);
+
+    /**
+     * @brief Particle definition of a PDG code (ions through the ion table)
+     * @param pdg PDG encoding; 0 stands for the geantino
+     * @return Particle definition, or nullptr if unknown
+     */
+    static const G4ParticleDefinition* FindParticle(G4int pdg);
+
+  private:
+    /** @brief Open fFileName and check its header */
+    G4bool Open();
+
+    /** @brief Read record i into the record */
+    G4bool ReadRecord(uint64_t i, PhaseSpaceRecord& record);
+
+    /** @brief First record of an original event at or after record i */
+    uint64_t AlignToEvent(uint64_t i);
+
+    /** @brief Add a record as a primary vertex to the event */
+    void AddPrimary(G4Event* event, const PhaseSpaceRecord& record, G4double phi) const;
+
+    std::ifstream fFile;          ///< Open phase-space file
+    G4String fOpenFileName;       ///< Name of the open file
+    uint64_t fNRecords = 0;       ///< Number of records in the file
+    uint64_t fNext = 0;           ///< Next record in sequential mode
+    uint64_t fFirst = 0;          ///< First record of this thread/process
+    uint64_t fEnd = 0;            ///< End of the records of this thread/process
+
+    static G4String fFileName;    ///< File to replay
+    static G4bool   fRandom;      ///< Random instead of sequential replay
+    static G4bool   fRandomPhi;   ///< Random rotation about z
+};
+
+#endif
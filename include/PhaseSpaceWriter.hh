@@ -0,0 +1,109 @@
+#ifndef PhaseSpaceWriter_h
+#define PhaseSpaceWriter_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class G4Step;
+class G4LogicalVolume;
+
+/**
+ * @class PhaseSpaceWriter
+ * @brief Records particles entering "record_surface" volumes to a phase-space file
+ *
+ * Volumes flagged with "record_surface" in the geometry JSON are registered by
+ * the GeometryParser.  SteppingAction passes every step to Record(); a particle
+ * entering a registered volume is written to the phase-space file (see
+ * PhaseSpaceRecord for the format) and optionally killed.  The file can be
+ * replayed with /source/type phasespace.
+ *
+ * In multi-threaded runs every worker writes its own file (<stem>_t<id><ext>).
+ *
+ * The first run of a job that records to a file creates it; later runs of the
+ * job append to it and add their events to the primary count in the header,
+ * with event numbers continuing those of the earlier runs.
+ * /phasespace/setFileName starts the named file afresh at its next run.  The
+ * source and geometry sweeps record every grid point or variant to its own
+ * file, <stem>_<point><ext> or <stem>_<variant><ext>.
+ */
+class PhaseSpaceWriter
+{
+  public:
+    /** @brief Create the /phasespace/ messenger (once) */
+    static void CreateMessenger();
+
+    /**
+     * @brief Set the output file name (default phasespace.bin)
+     * @param name File name
+     * @param restart Create the file afresh at the next run instead of appending
+     */
+    static void SetFileName(const G4String& name, G4bool restart = true);
+
+    /// Output file name
+    static const G4String& GetFileName() { return fFileName; }
+
+    /**
+     * @brief File name with a suffix added to its stem
+     * @param name File name
+     * @param suffix Suffix, e.g. a sweep point
+     * @return <stem>_<suffix><ext>
+     */
+    static G4String FileNameWithSuffix(const G4String& name, const std::string& suffix);
+
+    /** @brief Note that child processes recorded a run: later runs append */
+    static void MarkWritten();
+
+    /// Register a record surface: particles entering the volume are written
+    static void AddSurface(const G4LogicalVolume* volume, G4bool kill) { fSurfaces[volume] = kill; }
+
+    /// Forget all record surfaces (the geometry is being rebuilt)
+    static void ClearSurfaces() { fSurfaces.clear(); }
+
+    /// True if any record surface is defined
+    static G4bool IsRecording() { return !fSurfaces.empty(); }
+
+    /** @brief Writer of the calling thread */
+    static PhaseSpaceWriter* Instance();
+
+    /** @brief Open the output file if record surfaces are defined */
+    void BeginOfRun();
+
+    /**
+     * @brief Close the file and store the number of primary events in the header
+     * @param nEvents Number of events simulated by this thread
+     */
+    void EndOfRun(G4int nEvents);
+
+    /**
+     * @brief Write the track if it enters a record surface in this step
+     * @param step Step just taken
+     * @return True if the track has to be killed after recording
+     */
+    G4bool Record(const G4Step* step);
+
+  private:
+    PhaseSpaceWriter() = default;
+
+    std::ofstream fFile;            ///< Open phase-space file
+    G4String      fOpenFileName;    ///< Name of the open file
+    std::vector<char> fBuffer;      ///< Output buffer
+    G4long        fNRecords = 0;    ///< Records written in this run
+    uint64_t      fNPrimariesBefore = 0;  ///< Primaries of earlier runs in the open file
+
+    static G4String fFileName;                                  ///< Output file name
+    static std::set<std::string> fWritten;                      ///< Files created in this job
+    static std::map<const G4LogicalVolume*, G4bool> fSurfaces;  ///< Record surfaces and kill flags
+    static G4ThreadLocal PhaseSpaceWriter* fInstance;           ///< Writer of this thread
+
+    class PhaseSpaceMessenger;
+    static PhaseSpaceMessenger* fMessenger;
+    static bool fMessengerCreated;                              ///< Ensures messenger is created once
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "globals.hh"
+
+#include <string>
+
+class G4VUserPhysicsList;
+
+/**
+ * @class PhysicsTableCache
+ * @brief Node-local cache of the physics tables built at the first run
+ *
+ * With a cache directory set (/physics/setTableCache, --table-cache or
+ * $G4SIM_TABLE_CACHE) the first run of a job looks for tables stored by an
+ * earlier job under <dir>/<physics list>_<key>.  The key is a hash of the
+ * physics list, the Geant4 version, the EM parameters, the production cuts
+ * of every region and the composition of every material, so any change of
+ * these selects a different entry.  On a hit the tables are retrieved with
+ * Geant4's retrieve facility (which also checks the stored cuts table and
+ * rebuilds what cannot be retrieved); on a miss they are built as usual and
+ * then stored, under a temporary name renamed into place so that concurrent
+ * jobs never see a partial entry.  Hit or miss and the time taken are printed
+ * and stored as physics_table_cache and physics_tables_s in the tree user info.
+ *
+ * Only tables of processes that support storing are cached; HP neutron data
+ * and the nuclide table are still read at start-up.
+ */
+class PhysicsTableCache
+{
+  public:
+    /** @brief Create the /physics/ commands (once) */
+    static void CreateMessenger();
+
+    /// Cache directory ("" or "none" = no cache)
+    static void SetDirectory(const G4String& dir) { fDirectory = (dir == "none") ? "" : dir; }
+
+    /// Physics list name, part of the cache key
+    static void SetPhysicsListName(const G4String& name) { fPhysicsListName = name; }
+
+    /// True if a cache directory is set
+    static G4bool IsActive() { return !fDirectory.empty(); }
+
+    /**
+     * @brief Select retrieval of cached tables for the first run, if there are any
+     * @param physicsList Physics list about to build its tables
+     * @details Call before the run is initialised; later runs are left alone.
+     */
+    static void BeforeBuild(G4VUserPhysicsList* physicsList);
+
+    /**
+     * @brief Report the outcome and store the tables on a miss
+     * @param physicsList Physics list whose tables were built or retrieved
+     * @param seconds Time taken by the run initialisation
+     */
+    static void AfterBuild(G4VUserPhysicsList* physicsList, G4double seconds);
+
+  private:
+    /** @brief Everything the tables depend on, as text */
+    static std::string KeyText();
+
+    /** @brief 64-bit FNV-1a hash of a text, as 16 hex digits */
+    static std::string Hash(const std::string& text);
+
+    static G4String fDirectory;        ///< Cache directory ("" = off)
+    static G4String fPhysicsListName;  ///< Physics list name
+    static G4String fEntry;            ///< Entry of the pending build ("" = none)
+    static G4bool   fHit;              ///< The pending build retrieves
+    static G4bool   fDone;             ///< The first run has been initialised
+
+    class CacheMessenger;
+    static CacheMessenger* fMessenger;
+    static bool fMessengerCreated;     ///< Ensures messenger is created once
+};
+
+#endif
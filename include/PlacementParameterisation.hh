@@ -0,0 +1,50 @@
+#ifndef PlacementParameterisation_h
+#define PlacementParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+#include "G4RotationMatrix.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+/**
+ * @class PlacementParameterisation
+ * @brief Positions the copies of a generated placement pattern
+ *
+ * Used by GeometryParser when a placement "pattern" is marked as
+ * parameterised: all copies of the volume are represented by a single
+ * G4PVParameterised, and this class supplies the translation and rotation
+ * of each copy number.  The shape and material of the copies are unchanged.
+ */
+class PlacementParameterisation : public G4VPVParameterisation
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param positions Position of each copy in the mother frame
+     * @param rotations Rotation of each copy (nullptr for none); ownership is taken
+     */
+    PlacementParameterisation(const std::vector<G4ThreeVector>& positions,
+                              const std::vector<G4RotationMatrix*>& rotations);
+
+    /** @brief Destructor – deletes the owned rotation matrices */
+    ~PlacementParameterisation() override;
+
+    /**
+     * @brief Set the transformation of one copy
+     * @param copyNo Copy number of the volume
+     * @param physVol Parameterised physical volume to update
+     */
+    void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const override;
+
+    /** @brief Number of copies described by this parameterisation */
+    G4int GetNumberOfCopies() const { return static_cast<G4int>(fPositions.size()); }
+
+  private:
+    std::vector<G4ThreeVector>     fPositions;  ///< Copy positions
+    std::vector<G4RotationMatrix*> fRotations;  ///< Copy rotations (owned, may be nullptr)
+};
+
+#endif
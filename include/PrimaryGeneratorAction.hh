@@ -6,6 +6,10 @@
 
 class G4GeneralParticleSource;
 class G4Event;
+class SourceSweep;
+class PhaseSpaceSource;
+class EventFileSource;
+class ConfinementSampler;
 
 /**
  * @class PrimaryGeneratorAction
@@ -20,6 +24,15 @@ class G4Event;
  * - Multiple overlapping sources with individual intensities
  *
  * All configuration is done at run-time via /gps/ macro commands.
+ *
+ * With /source/type phasespace the primaries are instead replayed from a
+ * phase-space file written at a record surface (see PhaseSpaceSource); with
+ * /source/type file whole events are read from a binary or HepMC3 ASCII file
+ * (see EventFileSource).
+ *
+ * With /source/confine/volume the GPS vertex positions are replaced by points
+ * drawn uniformly inside (or on) the named volumes (see ConfinementSampler),
+ * a faster alternative to /gps/pos/confine for small or thin volumes.
  */
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -39,8 +52,24 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     /** @brief Accessor for the GPS object */
     const G4GeneralParticleSource* GetGPS() const { return fGPS; }
 
+    /// Select the source: "gps" (default), "phasespace" or "file"
+    static void SetSourceType(const G4String& type) { fSourceType = type; }
+
+    /// Selected source
+    static const G4String& GetSourceType() { return fSourceType; }
+
   private:
     G4GeneralParticleSource* fGPS;  ///< Pointer to the General Particle Source
+    PhaseSpaceSource* fPhaseSpace;  ///< Phase-space replay, created on first use
+    EventFileSource* fEventFile;    ///< Event file input, created on first use
+    ConfinementSampler* fConfinement;  ///< Volume-confined vertex positions
+
+    static G4String fSourceType;       ///< Source type shared by all instances
+
+    class SourceMessenger;
+    static SourceMessenger* fMessenger;  ///< Messenger for /source/ commands, created once
+
+    static SourceSweep* fSourceSweep;  ///< Source parameter sweep (/sweep/source/), created once
 };
 
 #endif
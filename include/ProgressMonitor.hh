@@ -0,0 +1,81 @@
+#ifndef ProgressMonitor_h
+#define ProgressMonitor_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <string>
+
+/**
+ * @class ProgressMonitor
+ * @brief Periodically rewrites a small JSON file with the progress of the run
+ *
+ * With /output/progressFile (or --progress-file) set, the file is rewritten
+ * at the start and end of every run and, during the run, at most once per
+ * /output/progressInterval after an event finishes.  It holds the events
+ * done and planned, the event rate (overall, per thread and over the last
+ * interval), the ETA, the resident memory, the mean number of hits per event
+ * and the output file with its current size.  The file is written to a
+ * temporary name and renamed, so readers never see a partial file.
+ *
+ * The "updated" time only advances when events finish: a file that stops
+ * changing while "status" is "running" means the job is stuck in an event.
+ */
+class ProgressMonitor
+{
+  public:
+    /** @brief Create the /output/progress* commands (once) */
+    static void CreateMessenger();
+
+    /// Set the status file ("" or "none" = off)
+    static void SetFileName(const G4String& name) { fFileName = (name == "none") ? "" : name; }
+
+    /// Minimum time between two updates during a run [s]
+    static void SetInterval(G4double seconds) { fInterval = seconds; }
+
+    /**
+     * @brief Reset the counters and write the initial status
+     * @param runID Run ID
+     * @param nPlanned Number of events to be processed
+     * @param outputFile ROOT file the run writes
+     */
+    static void BeginOfRun(G4int runID, G4int nPlanned, const G4String& outputFile);
+
+    /**
+     * @brief Count a finished event and rewrite the file if it is due
+     * @param nHits Number of hits of the event
+     */
+    static void EndOfEvent(G4long nHits);
+
+    /** @brief Write the final status of the run */
+    static void EndOfRun();
+
+  private:
+    /** @brief Write the status file (caller holds the lock) */
+    static void Write(const std::string& status);
+
+    /** @brief Resident set size of this process in bytes (0 if unknown) */
+    static G4long ResidentMemory();
+
+    using Clock = std::chrono::steady_clock;
+
+    static G4String fFileName;            ///< Status file ("" = off)
+    static G4double fInterval;            ///< Minimum time between updates [s]
+
+    static G4int    fRunID;               ///< Current run
+    static G4int    fNPlanned;            ///< Events to be processed
+    static G4String fOutputFile;          ///< ROOT file of the run
+    static G4long   fNDone;               ///< Events finished
+    static G4long   fNHits;               ///< Hits in the finished events
+    static std::map<G4int, G4long> fThreadEvents;  ///< Events finished per thread
+    static Clock::time_point fStart;      ///< Start of the run
+    static Clock::time_point fLastWrite;  ///< Time of the last update
+    static G4long   fNDoneLastWrite;      ///< Events finished at the last update
+
+    class ProgressMessenger;
+    static ProgressMessenger* fMessenger;
+    static bool fMessengerCreated;        ///< Ensures messenger is created once
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef RegionStepLimiter_h
+#define RegionStepLimiter_h 1
+
+#include "G4StepLimiterPhysics.hh"
+#include "globals.hh"
+
+/**
+ * @class RegionStepLimiter
+ * @brief G4StepLimiterPhysics, attached only when the geometry uses user limits
+ *
+ * The constructor is always registered in the physics list.  When a region or
+ * logical volume of the geometry present at /run/initialize has G4UserLimits
+ * ("user_limits" of a region in the geometry JSON), ConstructProcess adds the
+ * step limiter and the user special cuts to every particle.  Otherwise nothing
+ * is attached, so jobs without limits pay no extra process per step.
+ */
+class RegionStepLimiter : public G4StepLimiterPhysics
+{
+  public:
+    RegionStepLimiter() = default;
+    ~RegionStepLimiter() override = default;
+
+    /** @brief Attach the step limiter if the geometry has user limits */
+    void ConstructProcess() override;
+
+    /// True once ConstructProcess ran (the processes can no longer be added)
+    static G4bool IsConstructed() { return fConstructed; }
+
+    /// True if the step limiter processes were attached
+    static G4bool IsActive() { return fActive; }
+
+  private:
+    /** @brief True if any region or logical volume has user limits */
+    static G4bool GeometryHasUserLimits();
+
+    static G4bool fConstructed;  ///< ConstructProcess ran
+    static G4bool fActive;       ///< Processes were attached
+};
+
+#endif
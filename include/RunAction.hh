@@ -6,6 +6,9 @@
 #include "G4UIcmdWithAString.hh"
 #include "globals.hh"
 
+#include <map>
+#include <string>
+
 class TFile;
 class TTree;
 
@@ -33,6 +36,24 @@ class RunAction : public G4UserRunAction
 
     /// Get the current output file name
     G4String GetOutputFileName() const { return fOutputFileName; }
+
+    /// Set the name of the event tree (default "events")
+    void SetTreeName(const G4String& name) { fTreeName = name; }
+
+    /// Get the name of the event tree
+    G4String GetTreeName() const { return fTreeName; }
+
+    /// Set the ROOT file open mode: "RECREATE" (default) or "UPDATE" to add trees to an existing file
+    void SetFileMode(const G4String& mode) { fFileMode = mode; }
+
+    /// Get the ROOT file open mode
+    G4String GetFileMode() const { return fFileMode; }
+
+    /// Attach a key/value pair to the event tree of the following runs (TTree user info)
+    static void SetMetadata(const std::string& key, const std::string& value) { fMetadata[key] = value; }
+
+    /// Stop attaching a metadata entry
+    static void RemoveMetadata(const std::string& key) { fMetadata.erase(key); }
     
   private:
     class RunActionMessenger;
@@ -41,6 +62,10 @@ class RunAction : public G4UserRunAction
     TFile* fRootFile;     ///< Pointer to ROOT output file
     TTree* fEventTree;    ///< Pointer to main data TTree
     G4String fOutputFileName;  ///< Configurable output file name
+    G4String fTreeName;        ///< Name of the event tree
+    G4String fFileMode;        ///< TFile open mode
+
+    static std::map<std::string, std::string> fMetadata;  ///< Run metadata written with the tree
 };
 
 #endif
@@ -0,0 +1,73 @@
+#ifndef SensitiveDetectorFactory_h
+#define SensitiveDetectorFactory_h 1
+
+#include "globals.hh"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+class G4VSensitiveDetector;
+
+/**
+ * @class SensitiveDetectorFactory
+ * @brief Registry of the sensitive detector types a hits collection can use
+ *
+ * The geometry JSON selects the type per collection:
+ *
+ *   "hitsCollectionName": "Target"                                  (tracker)
+ *   "hitsCollectionName": {"name": "Veto", "type": "calorimeter"}
+ *
+ * Built-in types:
+ *   - tracker:     MySensitiveDetector, one MyHit per step with energy deposit
+ *   - calorimeter: energy per volume (CalorimeterSD)
+ *   - counter:     entering tracks and fluence per volume (CounterSD)
+ *   - timing:      first-hit time and energy per volume (TimingSD)
+ *
+ * Further types can be added with Register() before the geometry is built.
+ */
+class SensitiveDetectorFactory
+{
+  public:
+    /// Creates a detector from its name and its hits collection name
+    using Creator = std::function<G4VSensitiveDetector*(const G4String& sdName,
+                                                        const G4String& collectionName)>;
+
+    /// Type used when the JSON gives only a collection name
+    static const G4String DefaultType;
+
+    /**
+     * @brief Add or replace a detector type
+     * @param type Type name used in the geometry JSON
+     * @param creator Function creating a detector of this type
+     */
+    static void Register(const G4String& type, Creator creator);
+
+    /**
+     * @brief Create a detector of a registered type
+     * @param type Type name
+     * @param sdName Name of the detector
+     * @param collectionName Name of its hits collection (the branch prefix)
+     * @return New detector, or nullptr if the type is unknown
+     */
+    static G4VSensitiveDetector* Create(const G4String& type, const G4String& sdName,
+                                        const G4String& collectionName);
+
+    /// True if the type is registered
+    static G4bool IsKnown(const G4String& type);
+
+    /// Registered type names, sorted
+    static std::vector<G4String> Types();
+
+    /**
+     * @brief Name of the detector of a collection and type
+     * @return <collection>_SD for the default type, <collection>_<type>_SD otherwise
+     */
+    static G4String DetectorName(const G4String& collectionName, const G4String& type);
+
+  private:
+    /** @brief The registry, with the built-in types on first use */
+    static std::map<G4String, Creator>& Registry();
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SimRunManager_h
+#define SimRunManager_h 1
+
+#include "G4RunManager.hh"
+#include "globals.hh"
+
+/**
+ * @class SimRunManager
+ * @brief Serial run manager that can split every run over forked processes
+ *
+ * With SetNumberOfProcesses(N) each BeamOn first builds the physics tables
+ * in this process (BeamOn(0)) and then forks N children.  The children share
+ * the geometry, the physics tables and the loaded HP data copy-on-write, so
+ * the start-up cost is paid once.  Every child gets its own seeds, drawn from
+ * this process's engine, runs its share of the events and writes its own
+ * output shard (<stem>_p<i>.root).  When all children have finished the
+ * shards are merged into the output file and deleted.
+ *
+ * The first run initialisation retrieves or stores the physics tables in the
+ * PhysicsTableCache, if a cache directory is set.
+ *
+ * Before every event a SimulationServer client gets its progress and can
+ * query the status or abort the run.
+ *
+ * Every event is reseeded by EventSeeder (if a master seed is set), and the
+ * event count of every BeamOn can be overridden with --n-events; children
+ * number their events from their first event in the whole run.
+ *
+ * Without processes (the default) it behaves exactly like G4RunManager.
+ */
+class SimRunManager : public G4RunManager
+{
+  public:
+    SimRunManager();
+    ~SimRunManager() override;
+
+    /**
+     * @brief Run n_event events, split over the child processes if requested
+     * @param n_event Number of events
+     * @param macroFile Macro executed for the first n_select events
+     * @param n_select Number of events the macro is executed for
+     */
+    void BeamOn(G4int n_event, const char* macroFile = nullptr, G4int n_select = -1) override;
+
+    /** @brief Initialise the run, using the physics table cache for the first one */
+    void RunInitialization() override;
+
+    /// Number of child processes per run (0 or 1 = run in this process)
+    static void SetNumberOfProcesses(G4int n) { fNProcesses = n; }
+
+    /// Number of child processes per run
+    static G4int GetNumberOfProcesses() { return fNProcesses; }
+
+    /// Index of this child process, or -1 in the parent / without processes
+    static G4int GetProcessIndex() { return fProcessIndex; }
+
+    /// Events of the run before this child's share (0 in the parent)
+    static G4long GetProcessFirstEvent() { return fProcessFirstEvent; }
+
+    /**
+     * @brief Per-process variant of an output file name
+     * @param name File name
+     * @param index Process index (default: this process)
+     * @return <stem>_p<index><ext>, or the name itself for index < 0
+     */
+    static G4String ShardFileName(const G4String& name, G4int index = fProcessIndex);
+
+  protected:
+    /**
+     * @brief Create the next event, reseeding the engine for it first
+     * @param i_event Event ID within the run
+     * @return New event with its primaries
+     */
+    G4Event* GenerateEvent(G4int i_event) override;
+
+  private:
+    /** @brief Merge the ROOT output shards of the children into the output file */
+    void MergeOutput(G4int nShards) const;
+
+    static G4int fNProcesses;     ///< Child processes per run
+    static G4int fProcessIndex;   ///< Index of this child, -1 in the parent
+    static G4long fProcessFirstEvent; ///< Events of the run before this child's share
+};
+
+#endif
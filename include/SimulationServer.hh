@@ -0,0 +1,96 @@
+#ifndef SimulationServer_h
+#define SimulationServer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <string>
+
+/**
+ * @class SimulationServer
+ * @brief Keeps an initialised G4sim serving commands on a Unix domain socket
+ *
+ * With --daemon <socket> G4sim initialises once (geometry and physics tables,
+ * via /run/beamOn 0) and then serves one client at a time.  Every request is
+ * one line: a UI command (/gps/..., /run/beamOn N, /output/setFileName,
+ * /detector/setGeometryFile + /detector/rebuild, /control/execute ...) or one
+ * of the keywords
+ *
+ *   status    state of the server and of the current run
+ *   abort     finish the current event and end the run
+ *   reset     restore the run settings a fresh G4sim starts with
+ *   shutdown  close the socket and exit
+ *
+ * UI settings persist from one request to the next, so consecutive runs
+ * share them.  reset returns to the start-up state of: GPS (all sources
+ * removed, one default source, no multiple vertex or flat sampling), the
+ * /source/ settings (type gps, no confinement volumes, phase-space replay
+ * of phasespace.bin sequential without random phi, file format auto), all
+ * /kill/ rules, /decay/setTimeWindow 0, the /sweep/source/ and
+ * /detector/sweep/ lists, /random/setMasterSeed 0 and setFirstEvent 0,
+ * /phasespace/setFileName phasespace.bin, the /output/ tree name, file mode
+ * and summarise flag, /hits/setVerbose 0, and the state of the random
+ * engine when the server started.  Not reset: the geometry, the
+ * /source/file/name and /output/ file names (set them per run), the
+ * /output/progress settings, /profile/ and /physics/.
+ *
+ * Replies are JSON objects, one per line.  While a request runs, its output
+ * is streamed as {"type":"log"} lines and, during a run, {"type":"progress"}
+ * lines at most every 0.5 s; every request ends with exactly one
+ * {"type":"done"} line naming the request, with "ok" and, for UI commands,
+ * the G4UIcommandStatus "code".  A client gets a {"type":"ready"} line on
+ * connecting.  During a run only status and abort are answered (their done
+ * lines come between the run's own lines); other requests are refused as busy.
+ */
+class SimulationServer
+{
+  public:
+    /**
+     * @brief Serve requests on a socket until shutdown
+     * @param socketPath Path of the Unix domain socket (replaced if it exists)
+     * @return Exit code of the program
+     */
+    static G4int Serve(const G4String& socketPath);
+
+    /**
+     * @brief Answer status and abort requests and report progress during a run
+     * @param runID Current run
+     * @param iEvent Event about to be generated
+     * @param nPlanned Events of the run
+     * @details Called before every event; does nothing when not serving.
+     */
+    static void Poll(G4int runID, G4int iEvent, G4int nPlanned)
+    { if (fClient >= 0) PollClient(runID, iEvent, nPlanned); }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Handle one request line from the client */
+    static void Handle(const std::string& line);
+
+    /** @brief Send a JSON line to the client (dropped if it has gone) */
+    static void Send(const std::string& line);
+
+    /** @brief Poll() for a connected client */
+    static void PollClient(G4int runID, G4int iEvent, G4int nPlanned);
+
+    /** @brief Read what the client sent into the input buffer; false if it has gone */
+    static G4bool Receive(G4bool wait);
+
+    class StreamDestination;
+
+    static G4int       fClient;        ///< Connected client socket (-1 = none)
+    static std::string fInput;         ///< Received, not yet handled input
+    static G4bool      fBusy;          ///< A UI command is being executed
+    static G4bool      fShutdown;      ///< Shutdown requested
+    static G4long      fNRequests;     ///< Requests handled
+    static std::string fEngineState;   ///< Random engine state when serving started
+    static G4int       fRunID;         ///< Run in progress or last run (-1 = none)
+    static G4int       fEventsStarted; ///< Events started in that run
+    static G4int       fEventsPlanned; ///< Events planned in that run
+    static Clock::time_point fStarted;      ///< Server start
+    static Clock::time_point fRunStart;     ///< Start of the current run
+    static Clock::time_point fLastProgress; ///< Last progress line sent
+};
+
+#endif
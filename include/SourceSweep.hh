@@ -0,0 +1,76 @@
+#ifndef SourceSweep_h
+#define SourceSweep_h 1
+
+#include "globals.hh"
+#include <string>
+#include <vector>
+
+/**
+ * @class SourceSweep
+ * @brief Runs a grid of source settings in one initialised run manager
+ *
+ * Every axis is a UI command (normally a /gps/ command) with a list of
+ * values.  The sweep runs the Cartesian product of all axes: for each grid
+ * point the commands are applied, N events are run and the events are written
+ * to their own tree (events_<point>) in one output file.  The command/value
+ * pairs of each point are stored as metadata in the tree user info.
+ *
+ * Commands live under /sweep/source/.
+ */
+class SourceSweep
+{
+  public:
+    /** @brief Constructor */
+    SourceSweep();
+
+    /** @brief Destructor */
+    ~SourceSweep();
+
+    /**
+     * @brief Add an axis with explicit values
+     * @param command UI command to apply, e.g. /gps/ene/mono
+     * @param values Parameter strings of the command, e.g. "100 keV"
+     */
+    void AddAxis(const std::string& command, const std::vector<std::string>& values);
+
+    /**
+     * @brief Add an axis with evenly spaced numeric values
+     * @param command UI command to apply
+     * @param min First value
+     * @param max Last value
+     * @param n Number of values
+     * @param unit Unit appended to every value (may be empty)
+     * @param logarithmic Space the values logarithmically instead of linearly
+     */
+    void AddRange(const std::string& command, G4double min, G4double max, G4int n,
+                  const std::string& unit, G4bool logarithmic);
+
+    /** @brief Remove all axes */
+    void Clear() { fAxes.clear(); }
+
+    /** @brief Print the axes and the number of grid points */
+    void List() const;
+
+    /**
+     * @brief Run every grid point
+     * @param nEvents Number of events per grid point
+     */
+    void Run(G4int nEvents);
+
+  private:
+    /** @brief One sweep axis */
+    struct Axis {
+        std::string command;               ///< UI command
+        std::vector<std::string> values;   ///< Parameter string for each step
+    };
+
+    /** @brief Number of grid points (product of the axis lengths) */
+    size_t NumberOfPoints() const;
+
+    class SweepMessenger;
+    SweepMessenger* fMessenger;   ///< Messenger for /sweep/source/ commands
+
+    std::vector<Axis> fAxes;      ///< Axes in the order they were added (last varies fastest)
+};
+
+#endif
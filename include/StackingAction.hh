@@ -0,0 +1,25 @@
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+
+/**
+ * @class StackingAction
+ * @brief Defers late decay products (DecayWindow) and kills new tracks
+ *        according to the KillPolicy before they are tracked
+ */
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction();
+    ~StackingAction() override;
+
+    /**
+     * @brief Classify a new track
+     * @param track Track about to be stacked
+     * @return fKill if the track is deferred or a KillPolicy rule applies, fUrgent otherwise
+     */
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef StepProfiler_h
+#define StepProfiler_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+class G4Step;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+/**
+ * @class StepProfiler
+ * @brief CPU time and step counts per (logical volume, particle, process)
+ *
+ * Only built with the CMake option G4SIM_PROFILING (which defines
+ * G4SIM_WITH_PROFILER) and then switched on with /profile/enable.  The time
+ * between two steps of a track (or the start of the track and its first step)
+ * is charged to the volume the step was taken in, the particle and the
+ * process that limited the step.  Each thread counts into its own table;
+ * the tables are merged at the end of the run, printed sorted by time and
+ * optionally written as CSV (/profile/setFileName).
+ */
+class StepProfiler
+{
+  public:
+    /** @brief Thread-local instance */
+    static StepProfiler* Instance();
+
+    /** @brief Create the /profile/ messenger (once) */
+    static void CreateMessenger();
+
+    /// Switch profiling on or off
+    static void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+
+    /// True if profiling is switched on
+    static G4bool IsEnabled() { return fEnabled; }
+
+    /// Number of rows printed at the end of the run
+    static void SetTop(G4int n) { fTop = n; }
+
+    /// CSV file for the full table ("" or "none" = no file)
+    static void SetFileName(const G4String& name) { fFileName = (name == "none") ? "" : name; }
+
+    /** @brief Start the clock of a new track */
+    void BeginOfTrack() { fLast = Clock::now(); }
+
+    /**
+     * @brief Charge the time since the last step to this step
+     * @param step Step just taken
+     */
+    void Step(const G4Step* step);
+
+    /** @brief Clear this thread's table (and, on the master, the merged one) */
+    void BeginOfRun(G4bool master);
+
+    /** @brief Add this thread's table to the merged one */
+    void EndOfRun();
+
+    /** @brief Print the merged table and write the CSV file */
+    static void Report();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Counters of one (volume, particle, process) combination */
+    struct Entry {
+        G4long   steps = 0;     ///< Number of steps
+        G4double seconds = 0.;  ///< CPU time [s]
+    };
+
+    /** @brief Table key: the pointers identify the objects within a thread */
+    struct Key {
+        const G4LogicalVolume* volume;
+        const G4ParticleDefinition* particle;
+        const G4VProcess* process;
+        bool operator==(const Key& other) const {
+            return volume == other.volume && particle == other.particle && process == other.process;
+        }
+    };
+
+    /** @brief Hash of a key */
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /// Merged table, keyed by volume, particle and process name
+    using NameKey = std::tuple<std::string, std::string, std::string>;
+
+    StepProfiler() = default;
+
+    std::unordered_map<Key, Entry, KeyHash> fTable;  ///< This thread's counters
+    Clock::time_point fLast;                         ///< Time of the last step
+
+    static G4ThreadLocal StepProfiler* fInstance;
+    static std::map<NameKey, Entry> fMerged;         ///< Counters of all threads
+    static G4bool   fEnabled;                        ///< Profiling switched on
+    static G4int    fTop;                            ///< Rows in the printed table
+    static G4String fFileName;                       ///< CSV output ("" = none)
+
+    class ProfileMessenger;
+    static ProfileMessenger* fMessenger;
+    static bool fMessengerCreated;                   ///< Ensures messenger is created once
+};
+
+#endif
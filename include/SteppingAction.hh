@@ -0,0 +1,24 @@
+#ifndef SteppingAction_h
+#define SteppingAction_h 1
+
+#include "G4UserSteppingAction.hh"
+
+/**
+ * @class SteppingAction
+ * @brief Records phase-space surface crossings and stops tracks according
+ *        to the KillPolicy after each step
+ */
+class SteppingAction : public G4UserSteppingAction
+{
+  public:
+    SteppingAction();
+    ~SteppingAction() override;
+
+    /**
+     * @brief Record surface crossings and check the step-level kill rules
+     * @param step Step just taken
+     */
+    void UserSteppingAction(const G4Step* step) override;
+};
+
+#endif
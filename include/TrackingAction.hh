@@ -0,0 +1,25 @@
+#ifndef TrackingAction_h
+#define TrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+
+/**
+ * @class TrackingAction
+ * @brief Starts the StepProfiler clock of every track
+ *
+ * Only registered in builds with the stepping profiler (G4SIM_WITH_PROFILER).
+ */
+class TrackingAction : public G4UserTrackingAction
+{
+  public:
+    TrackingAction();
+    ~TrackingAction() override;
+
+    /**
+     * @brief Start the profiler clock of the track
+     * @param track Track about to be transported
+     */
+    void PreUserTrackingAction(const G4Track* track) override;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef VolumeScoringSD_h
+#define VolumeScoringSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "Rtypes.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class G4Step;
+class G4StepPoint;
+class G4HCofThisEvent;
+class G4VPhysicalVolume;
+class TTree;
+
+/**
+ * @class VolumeScoringSD
+ * @brief Base of the sensitive detectors that score per volume without hits
+ *
+ * Instead of a MyHit per step these detectors add every step to the score
+ * of its volume, so ProcessHits() does no allocation once a volume has been
+ * seen.  Volumes are named like MyHit volumes (parameterised copies get
+ * _<copy>).  At the end of the event the volumes scored are written to the
+ * detector's branches in the event tree, in the order they were first seen:
+ *
+ *   <det>_nHits    number of volumes scored
+ *   <det>_volName  volume names
+ *
+ * plus the branches of the type.  The detector registers its hits collection
+ * name (the branch prefix) but adds no hits collection to the event.
+ */
+class VolumeScoringSD : public G4VSensitiveDetector
+{
+  public:
+    VolumeScoringSD(const G4String& name, const G4String& hitsCollectionName);
+    ~VolumeScoringSD() override = default;
+
+    void Initialize(G4HCofThisEvent* hce) override;
+    void EndOfEvent(G4HCofThisEvent* hce) override;
+
+    /**
+     * @brief Create the branches of this detector in a run's event tree
+     * @param tree Event tree
+     * @param det Branch prefix (the hits collection name)
+     */
+    void CreateBranches(TTree* tree, const std::string& det);
+
+    /// Number of volumes scored in the last event
+    G4int GetNumberOfVolumes() const { return fNVolumes; }
+
+  protected:
+    /// Score of one volume in the current event
+    struct Slot {
+      std::string name;             ///< Volume name
+      G4double    cubicVolume = 0.; ///< Volume of its solid
+      G4bool      touched = false;  ///< Scored in the current event
+      G4double    edep = 0.;        ///< Energy deposit
+      G4double    edepWeight = 0.;  ///< Energy deposit times track weight
+      G4double    trackLength = 0.; ///< Track length times track weight
+      G4double    entryWeight = 0.; ///< Summed weight of the tracks entering
+      G4double    time = 0.;        ///< Earliest time
+      G4int       nSteps = 0;       ///< Steps scored
+      G4int       nEntries = 0;     ///< Tracks entering
+    };
+
+    /**
+     * @brief Score of the volume of a step point, reset at its first use in the event
+     * @param point Pre-step point
+     */
+    Slot& SlotOf(const G4StepPoint* point);
+
+    /** @brief Create the branches of the type */
+    virtual void CreateTypeBranches(TTree* tree, const std::string& det) = 0;
+
+    /** @brief Clear the branch data of the type */
+    virtual void ClearTypeData() = 0;
+
+    /** @brief Append the score of a volume to the branch data of the type */
+    virtual void FillTypeData(const Slot& slot) = 0;
+
+  private:
+    /** @brief Find or create the slot of a volume (first step in it this run) */
+    size_t FindSlot(const G4StepPoint* point, const G4VPhysicalVolume* volume, G4int copy);
+
+    std::vector<Slot>   fSlots;     ///< Scores by slot
+    std::vector<size_t> fTouched;   ///< Slots scored in the current event
+    std::map<std::string, size_t> fSlotByName;  ///< Slot of every volume name
+    std::map<std::pair<const G4VPhysicalVolume*, G4int>, size_t> fSlotByVolume;  ///< Cache (this run)
+    const G4VPhysicalVolume* fLastVolume;  ///< Volume of the last step
+    G4int  fLastCopy;                      ///< Copy of the last step
+    size_t fLastSlot;                      ///< Slot of the last step
+    G4int  fRunID;                         ///< Run the volume cache belongs to
+
+    Int_t fNVolumes;                       ///< <det>_nHits
+    std::vector<std::string> fVolName;     ///< <det>_volName
+};
+
+/**
+ * @class CalorimeterSD
+ * @brief Energy deposit per volume
+ *
+ * Branches: <det>_E summed energy deposit [MeV], <det>_w energy-weighted
+ * average track weight, <det>_nHitsPerVol steps with deposit — the same as
+ * the per-volume summary of a tracker, without positions.
+ */
+class CalorimeterSD : public VolumeScoringSD
+{
+  public:
+    using VolumeScoringSD::VolumeScoringSD;
+
+    G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
+
+  protected:
+    void CreateTypeBranches(TTree* tree, const std::string& det) override;
+    void ClearTypeData() override;
+    void FillTypeData(const Slot& slot) override;
+
+  private:
+    std::vector<double> fE;            ///< <det>_E [MeV]
+    std::vector<double> fW;            ///< <det>_w
+    std::vector<int>    fNHitsPerVol;  ///< <det>_nHitsPerVol
+};
+
+/**
+ * @class CounterSD
+ * @brief Tracks entering and fluence per volume, for any particle
+ *
+ * Branches: <det>_nEntries tracks entering through the volume surface,
+ * <det>_wEntries their summed weight, <det>_fluence track-length fluence,
+ * the weighted track length divided by the volume [cm^-2].  The volume is
+ * that of the logical volume's solid.
+ */
+class CounterSD : public VolumeScoringSD
+{
+  public:
+    using VolumeScoringSD::VolumeScoringSD;
+
+    G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
+
+  protected:
+    void CreateTypeBranches(TTree* tree, const std::string& det) override;
+    void ClearTypeData() override;
+    void FillTypeData(const Slot& slot) override;
+
+  private:
+    std::vector<int>    fNEntries;  ///< <det>_nEntries
+    std::vector<double> fWEntries;  ///< <det>_wEntries
+    std::vector<double> fFluence;   ///< <det>_fluence [cm^-2]
+};
+
+/**
+ * @class TimingSD
+ * @brief First-hit time and energy deposit per volume
+ *
+ * Branches: <det>_t global time of the first step with energy deposit (at
+ * its end point, like MyHit) [ns], <det>_E summed energy deposit [MeV].
+ */
+class TimingSD : public VolumeScoringSD
+{
+  public:
+    using VolumeScoringSD::VolumeScoringSD;
+
+    G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
+
+  protected:
+    void CreateTypeBranches(TTree* tree, const std::string& det) override;
+    void ClearTypeData() override;
+    void FillTypeData(const Slot& slot) override;
+
+  private:
+    std::vector<double> fT;  ///< <det>_t [ns]
+    std::vector<double> fE;  ///< <det>_E [MeV]
+};
+
+#endif
@@ -7,6 +7,11 @@
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
 #include "EventAction.hh"
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
+#ifdef G4SIM_WITH_PROFILER
+#include "TrackingAction.hh"
+#endif
 
 /**
  * @brief Constructor implementation
@@ -43,6 +48,9 @@ void ActionInitialization::BuildForMaster() const
  * Creates all necessary user actions for simulation:
  * 1. PrimaryGeneratorAction - Creates neutrons
  * 2. RunAction - Handles data collection
+ * 3. EventAction - Writes the hits of each event
+ * 4. StackingAction / SteppingAction - Apply the /kill/ rules
+ * 5. TrackingAction - Stepping profiler (profiler builds only)
  *
  * This method is called for each worker thread in MT mode,
  * and for the main thread in sequential mode.
@@ -52,4 +60,9 @@ void ActionInitialization::Build() const
     SetUserAction(new PrimaryGeneratorAction);
     SetUserAction(new RunAction);
     SetUserAction(new EventAction);
+    SetUserAction(new StackingAction);
+    SetUserAction(new SteppingAction);
+#ifdef G4SIM_WITH_PROFILER
+    SetUserAction(new TrackingAction);
+#endif
 }
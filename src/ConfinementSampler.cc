@@ -0,0 +1,204 @@
+/**
+ * @file ConfinementSampler.cc
+ * @brief Implementation of the ConfinementSampler class
+ */
+
+#include "ConfinementSampler.hh"
+#include "EventSeeder.hh"
+
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "Randomize.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+// ── Static members ──────────────────────────────────────
+std::vector<G4String> ConfinementSampler::fVolumeNames;
+G4bool ConfinementSampler::fSurface    = false;
+G4int  ConfinementSampler::fCacheSize  = 0;
+G4int  ConfinementSampler::fGeneration = 0;
+
+namespace {
+/// Attempts per point before giving up on a volume
+const G4int kMaxTries = 1000000;
+
+/// EventSeeder task number of the point table
+const uint64_t kCacheSeedStream = 1;
+}
+
+/**
+ * @brief Constructor implementation
+ */
+ConfinementSampler::ConfinementSampler()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+ConfinementSampler::~ConfinementSampler()
+{}
+
+/**
+ * @brief Find the placements of the named volumes in the current geometry
+ * @details Walks the geometry tree from the world and records the local-to-world
+ *          transform, bounding box and daughters of every placement.  Replicated
+ *          and parameterised volumes are skipped: their copies have no fixed
+ *          transform.
+ */
+void ConfinementSampler::FindPlacements()
+{
+  fPlacements.clear();
+  fCache.clear();
+
+  G4VPhysicalVolume* world =
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world) return;
+
+  G4double totalWeight = 0.;
+  std::function<void(const G4VPhysicalVolume*, const G4AffineTransform&)> visit =
+      [&](const G4VPhysicalVolume* pv, const G4AffineTransform& toWorld) {
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+    if (std::find(fVolumeNames.begin(), fVolumeNames.end(), pv->GetName()) != fVolumeNames.end()) {
+      Placement placement;
+      placement.volume = pv;
+      placement.toWorld = toWorld;
+      lv->GetSolid()->BoundingLimits(placement.boxMin, placement.boxMax);
+      for (size_t i = 0; i < lv->GetNoDaughters(); i++) {
+        const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+        if (daughter->IsReplicated()) {
+          G4cerr << "ConfinementSampler - Warning: points inside the replicated daughter "
+                 << daughter->GetName() << " of " << pv->GetName() << " are not excluded" << G4endl;
+          continue;
+        }
+        placement.daughters.push_back(daughter->GetLogicalVolume()->GetSolid());
+        placement.toDaughter.push_back(
+            G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation()).Inverse());
+      }
+      G4VSolid* solid = lv->GetSolid();
+      totalWeight += fSurface ? solid->GetSurfaceArea() : solid->GetCubicVolume();
+      placement.weight = totalWeight;
+      fPlacements.push_back(placement);
+    }
+
+    for (size_t i = 0; i < lv->GetNoDaughters(); i++) {
+      const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      if (daughter->IsReplicated()) continue;
+      visit(daughter, G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation()) * toWorld);
+    }
+  };
+  visit(world, G4AffineTransform());
+
+  if (fPlacements.empty()) {
+    G4cerr << "ConfinementSampler - Error: none of the confining volumes is placed in the geometry" << G4endl;
+  } else {
+    G4cout << "ConfinementSampler - Sampling " << (fSurface ? "on the surface of " : "inside ")
+           << fPlacements.size() << " placement(s)" << G4endl;
+  }
+}
+
+/**
+ * @brief Draw a point without the cache
+ * @param point Sampled point in world coordinates
+ * @return False if no point was accepted
+ * @details Placements are chosen in proportion to their solid's volume (surface
+ *          area in surface mode); the point is drawn uniformly in the bounding box
+ *          until it lies in the solid.  A point inside a daughter is rejected
+ *          together with its placement, which is then drawn again: the volume of
+ *          a solid includes its daughters, so keeping the placement would favour
+ *          placements with large daughters over the others.
+ */
+G4bool ConfinementSampler::SampleDirect(G4ThreeVector& point) const
+{
+  if (fPlacements.empty()) return false;
+
+  const Placement* placement = nullptr;
+  for (G4int attempt = 0; attempt < kMaxTries; attempt++) {
+    G4double r = G4UniformRand() * fPlacements.back().weight;
+    auto it = std::upper_bound(fPlacements.begin(), fPlacements.end(), r,
+                               [](G4double value, const Placement& p) { return value < p.weight; });
+    placement = (it != fPlacements.end()) ? &*it : &fPlacements.back();
+    const G4VSolid* solid = placement->volume->GetLogicalVolume()->GetSolid();
+
+    if (fSurface) {
+      point = placement->toWorld.TransformPoint(solid->GetPointOnSurface());
+      return true;
+    }
+
+    const G4ThreeVector size = placement->boxMax - placement->boxMin;
+    G4ThreeVector local;
+    do {
+      local = placement->boxMin + G4ThreeVector(size.x() * G4UniformRand(),
+                                                size.y() * G4UniformRand(),
+                                                size.z() * G4UniformRand());
+    } while (solid->Inside(local) == kOutside && ++attempt < kMaxTries);
+    if (attempt >= kMaxTries) break;
+
+    G4bool inDaughter = false;
+    for (size_t i = 0; i < placement->daughters.size() && !inDaughter; i++) {
+      inDaughter = placement->daughters[i]->Inside(placement->toDaughter[i].TransformPoint(local)) != kOutside;
+    }
+    if (inDaughter) continue;
+
+    point = placement->toWorld.TransformPoint(local);
+    return true;
+  }
+
+  G4cerr << "ConfinementSampler - Error: no point found in " << placement->volume->GetName()
+         << " after " << kMaxTries << " attempts" << G4endl;
+  return false;
+}
+
+/**
+ * @brief Draw a point
+ * @param point Sampled point in world coordinates
+ * @return False if no point could be found
+ * @details The placements are looked up again at the start of every run, since the
+ *          geometry may have been rebuilt; the point table is refilled with them.
+ *          With a master seed the table is drawn from its own seed of the run and
+ *          the engine state of the event is restored afterwards, so the table and
+ *          the event do not depend on which event of the job builds it.
+ */
+G4bool ConfinementSampler::Sample(G4ThreeVector& point)
+{
+  const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  G4int runID = run ? run->GetRunID() : -1;
+  if (runID != fRunID || fGeneration != fSetupGeneration) {
+    FindPlacements();
+    fRunID = runID;
+    fSetupGeneration = fGeneration;
+
+    if (fCacheSize > 0 && !fPlacements.empty()) {
+      std::ostringstream eventState;
+      if (EventSeeder::IsActive()) {
+        G4Random::saveFullState(eventState);
+        EventSeeder::SeedRunTask(runID, kCacheSeedStream);
+      }
+      fCache.reserve(fCacheSize);
+      G4ThreeVector cached;
+      while (G4int(fCache.size()) < fCacheSize && SampleDirect(cached)) {
+        fCache.push_back(cached);
+      }
+      if (EventSeeder::IsActive()) {
+        std::istringstream restored(eventState.str());
+        G4Random::restoreFullState(restored);
+      }
+      G4cout << "ConfinementSampler - " << fCache.size() << " point(s) cached" << G4endl;
+    }
+  }
+
+  if (!fCache.empty()) {
+    size_t i = std::min(size_t(G4UniformRand() * fCache.size()), fCache.size() - 1);
+    point = fCache[i];
+    return true;
+  }
+  return SampleDirect(point);
+}
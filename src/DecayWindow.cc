@@ -0,0 +1,162 @@
+/**
+ * @file DecayWindow.cc
+ * @brief Implementation of the DecayWindow and DecayEventInformation classes
+ */
+
+#include "DecayWindow.hh"
+#include "EventSeeder.hh"
+
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4DecayProcessType.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4ios.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UImessenger.hh"
+
+// ── Static members ──────────────────────────────────────
+G4double DecayWindow::fTimeWindow = 0.;
+G4ThreadLocal DecayWindow* DecayWindow::fInstance = nullptr;
+bool DecayWindow::fMessengerCreated = false;
+DecayWindow::DecayMessenger* DecayWindow::fMessenger = nullptr;
+
+// ── Nested messenger for the /decay/ commands ───────────
+class DecayWindow::DecayMessenger : public G4UImessenger
+{
+public:
+  DecayMessenger() {
+    fDir = new G4UIdirectory("/decay/");
+    fDir->SetGuidance("Radioactive decay chain windowing");
+
+    fWindowCmd = new G4UIcmdWithADoubleAndUnit("/decay/setTimeWindow", this);
+    fWindowCmd->SetGuidance("Defer radioactive-decay products created later than this to new events");
+    fWindowCmd->SetGuidance("Each new event stores its time offset in the timeOffset branch (0 = off)");
+    fWindowCmd->SetParameterName("window", false);
+    fWindowCmd->SetRange("window>=0");
+    fWindowCmd->SetDefaultUnit("us");
+    fWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  }
+  ~DecayMessenger() override { delete fWindowCmd; delete fDir; }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fWindowCmd)
+      DecayWindow::SetTimeWindow(fWindowCmd->GetNewDoubleValue(val));
+  }
+private:
+  G4UIdirectory*             fDir;
+  G4UIcmdWithADoubleAndUnit* fWindowCmd;
+};
+
+/**
+ * @brief Print the event information
+ */
+void DecayEventInformation::Print() const
+{
+  G4cout << "DecayEventInformation - time offset " << G4BestUnit(fTimeOffset, "Time")
+         << ", chain started in event " << fOriginEvent << G4endl;
+}
+
+/**
+ * @brief Create the /decay/ messenger (once)
+ */
+void DecayWindow::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new DecayMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Queue of the calling thread
+ * @return Thread-local instance, created on first use
+ */
+DecayWindow* DecayWindow::Instance()
+{
+  if (!fInstance) fInstance = new DecayWindow();
+  return fInstance;
+}
+
+/**
+ * @brief Defer a new track to a later event if it is a late decay product
+ * @param track Track about to be stacked
+ * @return True if the track was queued and must not be tracked now
+ */
+G4bool DecayWindow::Defer(const G4Track* track)
+{
+  if (fTimeWindow <= 0 || track->GetGlobalTime() <= fTimeWindow) return false;
+
+  const G4VProcess* creator = track->GetCreatorProcess();
+  if (!creator || creator->GetProcessSubType() != DECAY_Radioactive) return false;
+
+  // Times in a deferred event are relative to its offset within the chain
+  G4long originEvent = 0;
+  G4double offset = 0.;
+  const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  if (event) {
+    originEvent = EventSeeder::GlobalEventID(event->GetEventID());
+    if (auto* info = dynamic_cast<DecayEventInformation*>(event->GetUserInformation())) {
+      originEvent = info->GetOriginEvent();
+      offset = info->GetTimeOffset();
+    }
+  }
+
+  fQueue.emplace(std::make_pair(originEvent, offset + track->GetGlobalTime()),
+                 DeferredTrack{track->GetDefinition(), track->GetMomentum(), track->GetPolarization(),
+                               track->GetPosition(), track->GetWeight()});
+  return true;
+}
+
+/**
+ * @brief Fill an event with the next group of deferred tracks
+ * @param event Event to add the primaries to
+ * @return False if nothing was pending
+ * @details Chains are finished in the order they started: the group is the earliest
+ *          deferred track of the oldest chain plus every track of that chain within
+ *          one window of it.
+ */
+G4bool DecayWindow::GeneratePrimaries(G4Event* event)
+{
+  if (fQueue.empty()) return false;
+
+  auto first = fQueue.begin();
+  const G4long originEvent = first->first.first;
+  const G4double offset = first->first.second;
+
+  auto it = first;
+  while (it != fQueue.end() && it->first.first == originEvent &&
+         it->first.second <= offset + fTimeWindow) {
+    const DeferredTrack& deferred = it->second;
+    auto* vertex = new G4PrimaryVertex(deferred.position, it->first.second - offset);
+    auto* particle = new G4PrimaryParticle(deferred.particle, deferred.momentum.x(),
+                                           deferred.momentum.y(), deferred.momentum.z());
+    particle->SetPolarization(deferred.polarization);
+    particle->SetWeight(deferred.weight);
+    vertex->SetPrimary(particle);
+    event->AddPrimaryVertex(vertex);
+    ++it;
+  }
+  fQueue.erase(first, it);
+
+  event->SetUserInformation(new DecayEventInformation(offset, originEvent));
+  return true;
+}
+
+/**
+ * @brief Drop all deferred tracks, reporting how many were left
+ */
+void DecayWindow::Clear()
+{
+  if (!fQueue.empty()) {
+    G4cout << "DecayWindow::Clear() - " << fQueue.size()
+           << " deferred decay product(s) were not simulated; run more events to finish the chains"
+           << G4endl;
+  }
+  fQueue.clear();
+}
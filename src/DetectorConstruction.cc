@@ -4,8 +4,10 @@
  */
 
 #include "DetectorConstruction.hh"
+#include "GeometrySweep.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "G4RunManager.hh"
 #include <stdexcept>
 
@@ -28,6 +30,7 @@ class DetectorConstruction::DetectorMessenger : public G4UImessenger
     G4UIdirectory*        fDetectorDir;
     G4UIcmdWithAString*   fGeometryFileCmd;
     G4UIcommand*          fRebuildCmd;
+    G4UIcmdWithAnInteger* fNavigationReportCmd;
 };
 
 /**
@@ -46,6 +49,15 @@ DetectorConstruction::DetectorMessenger::DetectorMessenger(DetectorConstruction*
     
     fRebuildCmd = new G4UIcommand("/detector/rebuild", this);
     fRebuildCmd->SetGuidance("Rebuild the geometry with the current configuration files");
+    fRebuildCmd->SetGuidance("Position, dimension, material and visibility changes are applied in place;");
+    fRebuildCmd->SetGuidance("other changes rebuild the whole geometry");
+
+    fNavigationReportCmd = new G4UIcmdWithAnInteger("/detector/navigationReport", this);
+    fNavigationReportCmd->SetGuidance("Print daughter counts and voxel statistics of mother volumes");
+    fNavigationReportCmd->SetGuidance("Only mothers with at least the given number of daughters are listed");
+    fNavigationReportCmd->SetParameterName("minDaughters", true);
+    fNavigationReportCmd->SetDefaultValue(2);
+    fNavigationReportCmd->SetRange("minDaughters>=1");
 }
 
 /**
@@ -55,6 +67,7 @@ DetectorConstruction::DetectorMessenger::~DetectorMessenger()
 {
     delete fGeometryFileCmd;
     delete fRebuildCmd;
+    delete fNavigationReportCmd;
     delete fDetectorDir;
 }
 
@@ -70,6 +83,8 @@ void DetectorConstruction::DetectorMessenger::SetNewValue(G4UIcommand* command,
         //fDetector->RebuildGeometry();
     } else if (command == fRebuildCmd) {
         fDetector->RebuildGeometry();
+    } else if (command == fNavigationReportCmd) {
+        fDetector->ReportNavigation(fNavigationReportCmd->GetNewIntValue(newValue));
     }
 }
 
@@ -83,11 +98,13 @@ void DetectorConstruction::DetectorMessenger::SetNewValue(G4UIcommand* command,
 DetectorConstruction::DetectorConstruction(const std::string& geomFile)
 : G4VUserDetectorConstruction(),
   fMessenger(nullptr),
-  geometryFile(geomFile)
+  geometryFile(geomFile),
+  fSweep(nullptr)
   //lXeVolume(nullptr)
 {
     // Create the messenger for this class
     fMessenger = new DetectorMessenger(this);
+    fSweep = new GeometrySweep(this);
 }
 
 /**
@@ -97,6 +114,7 @@ DetectorConstruction::DetectorConstruction(const std::string& geomFile)
  */
 DetectorConstruction::~DetectorConstruction()
 {
+    delete fSweep;
     delete fMessenger;
 }
 
@@ -118,7 +136,12 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     // print the file names:
     G4cout << "Geometry file: " << geometryFile << G4endl;
 
-    parser.LoadGeometryConfig(geometryFile);
+    if (pendingConfig.is_null()) {
+        parser.LoadGeometryConfig(geometryFile);
+    } else {
+        parser.LoadGeometryConfig(pendingConfig, geometryFile);
+        pendingConfig = json();
+    }
     // Construct the geometry
     G4VPhysicalVolume* worldPhys = parser.ConstructGeometry();
 
@@ -137,6 +160,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 void DetectorConstruction::SetGeometryFile(const G4String& path)
 {
     geometryFile = path;
+    pendingConfig = json();
     G4cout << "Geometry file set to: " << path << G4endl;
 }
 
@@ -153,19 +177,61 @@ void DetectorConstruction::SetGeometryFile(const G4String& path)
 /**
  * @brief Rebuild the geometry with the current configuration files
  * @return true if rebuild was successful, false otherwise
+ *
+ * The geometry file is compared with the one the current geometry was built
+ * from.  Moved placements, changed dimensions, materials and visualization
+ * settings are applied to the existing volumes; any other change triggers a
+ * full rebuild, for which the old volumes, solids and assemblies are deleted
+ * before Construct() is called again.
  */
 G4bool DetectorConstruction::RebuildGeometry()
 {
     G4cout << "Rebuilding geometry with:" << G4endl;
     G4cout << "  Geometry file: " << geometryFile << G4endl;
-    
-    // Clear any existing volumes and materials
-    parser = GeometryParser();
-    //lXeVolume = nullptr;
-    
-    // This will trigger Geant4 to call Construct() again
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
-    G4RunManager::GetRunManager()->GeometryHasBeenModified();
+
+    json config;
+    try {
+        config = GeometryParser::ReadJsonFile(geometryFile);
+    } catch (const std::exception& e) {
+        G4cerr << "DetectorConstruction::RebuildGeometry() - Error: " << e.what() << G4endl;
+        return false;
+    }
+    return RebuildGeometry(config);
+}
+
+/**
+ * @brief Rebuild the geometry from an already parsed configuration
+ * @param config Geometry configuration
+ * @return true if rebuild was successful, false otherwise
+ */
+G4bool DetectorConstruction::RebuildGeometry(const json& config)
+{
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+
+    // Nothing built yet: Construct() will use the configuration at initialisation
+    if (!parser.HasGeometry()) {
+        pendingConfig = config;
+        return true;
+    }
+
+    try {
+        G4bool materialsChanged = false;
+        if (parser.UpdateGeometry(config, geometryFile, materialsChanged)) {
+            runManager->GeometryHasBeenModified();
+            if (materialsChanged) {
+                runManager->PhysicsHasBeenModified();
+            }
+            return true;
+        }
+    } catch (const std::exception& e) {
+        G4cerr << "DetectorConstruction::RebuildGeometry() - Error: " << e.what() << G4endl;
+        return false;
+    }
+
+    // Full rebuild: delete the old geometry, then let Geant4 call Construct() again
+    runManager->ReinitializeGeometry(true);
+    parser.ClearGeometry();
+    pendingConfig = config;
     
     return true;
 }
@@ -1,12 +1,18 @@
 #include "EventAction.hh"
 #include "RunAction.hh"
 #include "MyHit.hh"
+#include "VolumeScoringSD.hh"
+#include "DecayWindow.hh"
+#include "EventSeeder.hh"
+#include "ProgressMonitor.hh"
 
 #include "G4Event.hh"
 #include "G4EventManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4SDManager.hh"
+#include "G4VSensitiveDetector.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ios.hh"
 #include "G4UIdirectory.hh"
@@ -45,7 +51,11 @@ private:
 EventAction::EventAction()
 : G4UserEventAction(),
   fCollectionsInitialized(false),
-  fTree(nullptr)
+  fTree(nullptr),
+  fTreeRunID(-1),
+  fEventID(0),
+  fTimeOffset(0.),
+  fOriginEvent(-1)
 {
   // Create the summarise messenger once
   if (!fSumMessengerCreated) {
@@ -58,9 +68,9 @@ EventAction::~EventAction()
 {}
 
 // ----------------------------------------------------------------
-// Called once on the first event: discover every hits collection
-// that was registered by the sensitive detectors and create a
-// matching set of branches in the ROOT TTree.
+// Called on the first event of every run: discover every hits
+// collection that was registered by the sensitive detectors and
+// create a matching set of branches in the run's ROOT TTree.
 // ----------------------------------------------------------------
 void EventAction::InitializeCollections()
 {
@@ -68,6 +78,25 @@ void EventAction::InitializeCollections()
   auto runAction = static_cast<const RunAction*>(
       G4RunManager::GetRunManager()->GetUserRunAction());
   fTree = runAction->GetEventTree();
+  fTreeRunID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+
+  // Start from scratch: the previous tree is gone and the geometry may
+  // have been rebuilt with different sensitive detectors
+  fHitsCollectionIDs.clear();
+  fScorers.clear();
+  fNHits.clear();
+  fX.clear();
+  fY.clear();
+  fZ.clear();
+  fE.clear();
+  fW.clear();
+  fVolName.clear();
+  fNHitsPerVol.clear();
+
+  // Event-level branches
+  fTree->Branch("eventID", &fEventID, "eventID/L");
+  fTree->Branch("timeOffset", &fTimeOffset, "timeOffset/D");
+  fTree->Branch("originEvent", &fOriginEvent, "originEvent/L");
 
   // Discover all hits collections
   G4SDManager* sdManager = G4SDManager::GetSDMpointer();
@@ -82,6 +111,20 @@ void EventAction::InitializeCollections()
     // Use the hits-collection name as the detector key
     std::string det = std::string(hcName);
 
+    // A detector replaced by one of another type after a geometry rebuild
+    // stays registered, but inactive
+    G4VSensitiveDetector* sd = sdManager->FindSensitiveDetector(sdName, false);
+    if (sd && !sd->isActive()) continue;
+
+    // Per-volume scoring detectors create their own branches
+    if (auto* scorer = dynamic_cast<VolumeScoringSD*>(sd)) {
+      fScorers[det] = scorer;
+      scorer->CreateBranches(fTree, det);
+      G4cout << "Created ROOT branches for scoring detector \"" << det
+             << "\" (SD: " << sdName << ")" << G4endl;
+      continue;
+    }
+
     fHitsCollectionIDs[hcName] = id;
 
     // Initialise data maps for this detector
@@ -90,6 +133,7 @@ void EventAction::InitializeCollections()
     fY[det]     = {};
     fZ[det]     = {};
     fE[det]     = {};
+    fW[det]     = {};
     fVolName[det] = {};
     fNHitsPerVol[det] = {};
 
@@ -99,6 +143,7 @@ void EventAction::InitializeCollections()
     fTree->Branch((det + "_y").c_str(),     &fY[det]);
     fTree->Branch((det + "_z").c_str(),     &fZ[det]);
     fTree->Branch((det + "_E").c_str(),     &fE[det]);
+    fTree->Branch((det + "_w").c_str(),     &fW[det]);
     fTree->Branch((det + "_volName").c_str(), &fVolName[det]);
     fTree->Branch((det + "_nHitsPerVol").c_str(), &fNHitsPerVol[det]);
 
@@ -121,11 +166,23 @@ void EventAction::BeginOfEventAction(const G4Event* event)
 // ----------------------------------------------------------------
 void EventAction::EndOfEventAction(const G4Event* event)
 {
-  // Lazy initialisation of branch bookkeeping
-  if (!fCollectionsInitialized) {
+  // Lazy initialisation of branch bookkeeping (RunAction opens a new tree per run)
+  if (!fCollectionsInitialized ||
+      G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID() != fTreeRunID) {
     InitializeCollections();
   }
 
+  // Number of the event within the whole run (see EventSeeder)
+  fEventID     = EventSeeder::GlobalEventID(event->GetEventID());
+
+  // Position of the event within its decay chain (see DecayWindow)
+  fTimeOffset  = 0.;
+  fOriginEvent = fEventID;
+  if (auto* info = dynamic_cast<DecayEventInformation*>(event->GetUserInformation())) {
+    fTimeOffset  = info->GetTimeOffset() / ns;
+    fOriginEvent = info->GetOriginEvent();
+  }
+
   // Clear all vectors before filling
   for (auto& [det, _] : fNHits) {
     fNHits[det] = 0;
@@ -133,6 +190,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
     fY[det].clear();
     fZ[det].clear();
     fE[det].clear();
+    fW[det].clear();
     fVolName[det].clear();
     fNHitsPerVol[det].clear();
   }
@@ -140,9 +198,16 @@ void EventAction::EndOfEventAction(const G4Event* event)
   G4HCofThisEvent* hce = event->GetHCofThisEvent();
   if (!hce) {
     fTree->Fill();
+    ProgressMonitor::EndOfEvent(0);
     return;
   }
 
+  // Scoring detectors filled their branches at the end of the event
+  G4long nRawHits = 0;
+  for (const auto& [det, scorer] : fScorers) {
+    nRawHits += scorer->GetNumberOfVolumes();
+  }
+
   // Loop over every registered detector and fill vectors
   for (const auto& [hcName, id] : fHitsCollectionIDs) {
     auto* hc = static_cast<MyHitsCollection*>(hce->GetHC(id));
@@ -150,6 +215,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
 
     std::string det  = std::string(hcName);
     G4int       nHits = hc->entries();
+    nRawHits += nHits;
 
     if (fSummarize == 0) {
       // ── Detailed mode: one entry per hit ──
@@ -163,6 +229,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
         fY[det].push_back(pos.y() / mm);
         fZ[det].push_back(pos.z() / mm);
         fE[det].push_back(hit->GetEnergy() / MeV);
+        fW[det].push_back(hit->GetWeight());
         fVolName[det].push_back(std::string(hit->GetVolumeName()));
         fNHitsPerVol[det].push_back(1);
       }
@@ -174,6 +241,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
         double sumWX = 0.0;
         double sumWY = 0.0;
         double sumWZ = 0.0;
+        double sumWW = 0.0;
         int    count = 0;
       };
       std::map<std::string, VolAccum> accum;
@@ -189,6 +257,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
         a.sumWX += e * (pos.x() / mm);
         a.sumWY += e * (pos.y() / mm);
         a.sumWZ += e * (pos.z() / mm);
+        a.sumWW += e * hit->GetWeight();
         a.count++;
       }
 
@@ -200,10 +269,12 @@ void EventAction::EndOfEventAction(const G4Event* event)
           fX[det].push_back(a.sumWX / a.sumE);
           fY[det].push_back(a.sumWY / a.sumE);
           fZ[det].push_back(a.sumWZ / a.sumE);
+          fW[det].push_back(a.sumWW / a.sumE);
         } else {
           fX[det].push_back(0.0);
           fY[det].push_back(0.0);
           fZ[det].push_back(0.0);
+          fW[det].push_back(1.0);
         }
         fVolName[det].push_back(vn);
         fNHitsPerVol[det].push_back(a.count);
@@ -213,4 +284,5 @@ void EventAction::EndOfEventAction(const G4Event* event)
 
   // Fill the tree once per event
   fTree->Fill();
+  ProgressMonitor::EndOfEvent(nRawHits);
 }
@@ -0,0 +1,377 @@
+/**
+ * @file EventFileSource.cc
+ * @brief Implementation of the EventFileSource class
+ */
+
+#include "EventFileSource.hh"
+#include "PhaseSpaceRecord.hh"
+#include "PhaseSpaceSource.hh"
+#include "RunAction.hh"
+#include "SimRunManager.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+G4Mutex inputMutex = G4MUTEX_INITIALIZER;
+
+/// Start of the line after p (or end)
+const char* NextLine(const char* p, const char* end)
+{
+  const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return eol ? eol + 1 : end;
+}
+}
+
+// ── Static members ──────────────────────────────────────
+G4String EventFileSource::fFileName = "";
+EventFileSource::Format EventFileSource::fFormat = EventFileSource::kAuto;
+EventFileSource::MappedInput* EventFileSource::fShared = nullptr;
+std::string EventFileSource::fForkedFile;
+size_t EventFileSource::fForkedCursor = 0;
+
+/**
+ * @brief Constructor implementation
+ */
+EventFileSource::EventFileSource()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+EventFileSource::~EventFileSource()
+{}
+
+/**
+ * @brief Set the input format
+ * @param format "auto", "binary" or "hepmc3"
+ */
+void EventFileSource::SetFormat(const G4String& format)
+{
+  if (format == "binary") {
+    fFormat = kBinary;
+  } else if (format == "hepmc3") {
+    fFormat = kHepMC3;
+  } else {
+    fFormat = kAuto;
+  }
+}
+
+/**
+ * @brief Map a file and build its event index
+ * @param name File name
+ * @return Mapped input, or nullptr on error
+ */
+EventFileSource::MappedInput* EventFileSource::Open(const std::string& name)
+{
+  int fd = ::open(name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    G4cerr << "EventFileSource::Open() - Error: cannot open " << name << G4endl;
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+    G4cerr << "EventFileSource::Open() - Error: " << name << " is empty" << G4endl;
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    G4cerr << "EventFileSource::Open() - Error: cannot map " << name << G4endl;
+    return nullptr;
+  }
+  ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  auto* input = new MappedInput();
+  input->name = name;
+  input->data = static_cast<const char*>(data);
+  input->size = st.st_size;
+  const char* begin = input->data;
+  const char* end = begin + input->size;
+
+  input->format = fFormat;
+  if (input->format == kAuto) {
+    if (input->size >= sizeof(PhaseSpaceRecord::kMagic) &&
+        std::memcmp(begin, PhaseSpaceRecord::kMagic, sizeof(PhaseSpaceRecord::kMagic)) == 0) {
+      input->format = kBinary;
+    } else if (input->size >= 7 && std::memcmp(begin, "HepMC::", 7) == 0) {
+      input->format = kHepMC3;
+    } else {
+      G4cerr << "EventFileSource::Open() - Error: cannot tell the format of " << name
+             << "; use /source/file/format" << G4endl;
+      Close(input);
+      return nullptr;
+    }
+  }
+
+  // Event index: offset of the first record / "E" line of every event
+  if (input->format == kBinary) {
+    G4int previous = 0;
+    for (size_t offset = PhaseSpaceRecord::kHeaderSize;
+         offset + PhaseSpaceRecord::kRecordSize <= input->size;
+         offset += PhaseSpaceRecord::kRecordSize) {
+      int32_t eventNumber;
+      std::memcpy(&eventNumber, begin + offset, sizeof(eventNumber));
+      if (input->events.empty() || eventNumber != previous) input->events.push_back(offset);
+      previous = eventNumber;
+    }
+  } else {
+    for (const char* p = begin; p < end; p = NextLine(p, end)) {
+      if (p + 1 < end && p[0] == 'E' && p[1] == ' ') input->events.push_back(p - begin);
+    }
+  }
+  size_t nEvents = input->events.size();
+  input->events.push_back(input->size);
+
+  G4cout << "EventFileSource::Open() - " << name << ": " << nEvents << " event(s), "
+         << (input->format == kBinary ? "binary" : "HepMC3 ASCII") << G4endl;
+  return input;
+}
+
+/**
+ * @brief Close a mapped input
+ * @param input Input to unmap and delete
+ */
+void EventFileSource::Close(MappedInput* input)
+{
+  if (!input) return;
+  if (input->data) ::munmap(const_cast<char*>(input->data), input->size);
+  delete input;
+}
+
+/**
+ * @brief Shared input for fFileName, mapped and indexed on first use
+ * @return Mapped input, or nullptr if the file cannot be used
+ * @details The mapping is replaced when the file name or format changes, which
+ *          must only happen between runs.
+ */
+const EventFileSource::MappedInput* EventFileSource::Input()
+{
+  G4AutoLock lock(&inputMutex);
+  if (fShared && fShared->name == fFileName && (fFormat == kAuto || fShared->format == fFormat)) {
+    return fShared;
+  }
+  Close(fShared);
+  fShared = fFileName.empty() ? nullptr : Open(fFileName);
+  if (!fShared) return nullptr;
+  RunAction::SetMetadata("input_file", fFileName);
+  return fShared;
+}
+
+/**
+ * @brief Add the primaries of the next event in this thread's range
+ * @param event Event to add the primaries to
+ */
+void EventFileSource::GeneratePrimaries(G4Event* event)
+{
+  const MappedInput* input = Input();
+  if (!input) {
+    G4cerr << "EventFileSource::GeneratePrimaries() - Error: no usable input file "
+           << "(/source/file/name)" << G4endl;
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
+  }
+
+  // A forked child reads its share of this run's events from the parent's cursor;
+  // otherwise each worker thread reads its own contiguous range of events
+  const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  const G4int runID = run ? run->GetRunID() : -1;
+  const G4int process = SimRunManager::GetProcessIndex();
+  if (input != fInput || (process >= 0 && runID != fRunID)) {
+    fInput = input;
+    fRunID = runID;
+    size_t nEvents = input->events.size() - 1;
+    if (process >= 0) {
+      size_t cursor = (fForkedFile == input->name) ? fForkedCursor : 0;
+      size_t share = run ? size_t(run->GetNumberOfEventToBeProcessed()) : 0;
+      fNext = std::min(nEvents, cursor + size_t(SimRunManager::GetProcessFirstEvent()));
+      fEnd = std::min(nEvents, fNext + share);
+      G4cout << "EventFileSource::GeneratePrimaries() - Process " << process << " reads events ["
+             << fNext << ", " << fEnd << ") of " << input->name << G4endl;
+    } else {
+      size_t nParts = 1;
+      size_t part = 0;
+      if (G4Threading::IsWorkerThread()) {
+        nParts = std::max(1, G4Threading::GetNumberOfRunningWorkerThreads());
+        part = G4Threading::G4GetThreadId();
+      }
+      fNext = nEvents * part / nParts;
+      fEnd = nEvents * (part + 1) / nParts;
+    }
+  }
+
+  if (fNext >= fEnd) {
+    G4cerr << "EventFileSource::GeneratePrimaries() - End of the input events of this thread in "
+           << input->name << "; aborting the run" << G4endl;
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+
+  const char* begin = input->data + input->events[fNext];
+  const char* end = input->data + input->events[fNext + 1];
+  fNext++;
+  if (input->format == kBinary) {
+    ReadBinaryEvent(begin, end, event);
+  } else {
+    ReadHepMC3Event(begin, end, event);
+  }
+}
+
+/**
+ * @brief Move the input past the events of a run split over processes
+ * @param nEvents Events of the run
+ * @details The children read the run's events from the cursor on, each its
+ *          share; without this every run of the job would read the same events.
+ */
+void EventFileSource::AdvanceForkedRun(G4int nEvents)
+{
+  if (fForkedFile != std::string(fFileName)) {
+    fForkedFile = fFileName;
+    fForkedCursor = 0;
+  }
+  fForkedCursor += size_t(nEvents);
+}
+
+/**
+ * @brief Add the primaries of a binary event
+ * @param begin First record of the event
+ * @param end End of the event
+ * @param event Event to add the primaries to
+ */
+void EventFileSource::ReadBinaryEvent(const char* begin, const char* end, G4Event* event)
+{
+  PhaseSpaceRecord record;
+  for (const char* p = begin; p + PhaseSpaceRecord::kRecordSize <= end; p += PhaseSpaceRecord::kRecordSize) {
+    record.Unpack(p);
+    const G4ParticleDefinition* particle = PhaseSpaceSource::FindParticle(record.pdg);
+    if (!particle) {
+      G4cerr << "EventFileSource::ReadBinaryEvent() - Warning: unknown PDG code " << record.pdg << G4endl;
+      continue;
+    }
+    auto* vertex = new G4PrimaryVertex(record.position, record.time);
+    auto* primary = new G4PrimaryParticle(particle);
+    primary->SetKineticEnergy(record.energy);
+    primary->SetMomentumDirection(record.direction.unit());
+    primary->SetWeight(record.weight);
+    vertex->SetPrimary(primary);
+    event->AddPrimaryVertex(vertex);
+  }
+}
+
+/**
+ * @brief Add the primaries of a HepMC3 ASCII event
+ * @param begin "E" line of the event
+ * @param end End of the event
+ * @param event Event to add the primaries to
+ * @details Uses the U (units), V (vertex positions, "@ x y z t") and P (particles)
+ *          lines; every status-1 particle becomes a primary at its production
+ *          vertex, or at the event position if that vertex has none.
+ */
+void EventFileSource::ReadHepMC3Event(const char* begin, const char* end, G4Event* event)
+{
+  struct Position { G4ThreeVector x; G4double t = 0.; };
+  struct Particle { G4int vertex; G4int pdg; G4ThreeVector p; };
+
+  G4double momentumUnit = GeV;
+  G4double lengthUnit = mm;
+  Position eventPosition;
+  std::map<G4int, Position> vertices;
+  std::vector<Particle> particles;
+
+  // Position after an "@" in a line, in the current length unit
+  auto parsePosition = [&lengthUnit](const std::string& line, Position& position) {
+    size_t at = line.find('@');
+    if (at == std::string::npos) return false;
+    const char* p = line.c_str() + at + 1;
+    char* next;
+    G4double x = std::strtod(p, &next);
+    G4double y = std::strtod(next, &next);
+    G4double z = std::strtod(next, &next);
+    G4double t = std::strtod(next, &next);
+    position.x = G4ThreeVector(x, y, z) * lengthUnit;
+    position.t = t * lengthUnit / c_light;
+    return true;
+  };
+
+  std::string line;
+  for (const char* p = begin; p < end;) {
+    const char* next = NextLine(p, end);
+    line.assign(p, next);
+    p = next;
+    if (line.size() < 2 || line[1] != ' ') continue;
+
+    const char* fields = line.c_str() + 2;
+    char* rest;
+    switch (line[0]) {
+      case 'E':
+        parsePosition(line, eventPosition);
+        break;
+      case 'U':
+        momentumUnit = (line.find("MEV") != std::string::npos) ? MeV : GeV;
+        lengthUnit = (line.find("CM") != std::string::npos) ? cm : mm;
+        break;
+      case 'V': {
+        G4int id = std::strtol(fields, &rest, 10);
+        Position position;
+        if (parsePosition(line, position)) vertices[id] = position;
+        break;
+      }
+      case 'P': {
+        std::strtol(fields, &rest, 10);                 // particle id
+        G4int vertex = std::strtol(rest, &rest, 10);    // production vertex (<0) or parent particle
+        G4int pdg = std::strtol(rest, &rest, 10);
+        G4double px = std::strtod(rest, &rest);
+        G4double py = std::strtod(rest, &rest);
+        G4double pz = std::strtod(rest, &rest);
+        std::strtod(rest, &rest);                       // energy
+        std::strtod(rest, &rest);                       // mass
+        G4int status = std::strtol(rest, &rest, 10);
+        if (status == 1) {
+          particles.push_back({vertex, pdg, G4ThreeVector(px, py, pz) * momentumUnit});
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  std::map<G4int, G4PrimaryVertex*> primaryVertices;
+  for (const auto& particle : particles) {
+    const G4ParticleDefinition* definition = PhaseSpaceSource::FindParticle(particle.pdg);
+    if (!definition) {
+      G4cerr << "EventFileSource::ReadHepMC3Event() - Warning: unknown PDG code " << particle.pdg << G4endl;
+      continue;
+    }
+
+    G4int vertexID = (particle.vertex < 0) ? particle.vertex : 0;
+    G4PrimaryVertex*& vertex = primaryVertices[vertexID];
+    if (!vertex) {
+      auto it = vertices.find(vertexID);
+      const Position& position = (it != vertices.end()) ? it->second : eventPosition;
+      vertex = new G4PrimaryVertex(position.x, position.t);
+      event->AddPrimaryVertex(vertex);
+    }
+    vertex->SetPrimary(new G4PrimaryParticle(definition, particle.p.x(), particle.p.y(), particle.p.z()));
+  }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file EventSeeder.cc
+ * @brief Implementation of the EventSeeder class
+ */
+
+#include "EventSeeder.hh"
+#include "RunAction.hh"
+
+#include "Randomize.hh"
+#include "G4ios.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UImessenger.hh"
+
+#include <string>
+
+// ── Static members ──────────────────────────────────────
+G4long EventSeeder::fMasterSeed = 0;
+G4long EventSeeder::fFirstEvent = 0;
+G4int  EventSeeder::fNEvents    = -1;
+bool EventSeeder::fMessengerCreated = false;
+EventSeeder::SeedMessenger* EventSeeder::fMessenger = nullptr;
+
+// ── Nested messenger for the /random/ commands ──────────
+class EventSeeder::SeedMessenger : public G4UImessenger
+{
+public:
+  SeedMessenger() {
+    // /random/ directory already exists (created by the run manager)
+    // 64-bit parameters: seeds and event offsets of large splits exceed INT_MAX
+    fMasterSeedCmd = new G4UIcommand("/random/setMasterSeed", this);
+    fMasterSeedCmd->SetGuidance("Seed every event from this seed, the run ID and the event number");
+    fMasterSeedCmd->SetGuidance("Results then do not depend on how the run is split (0 = off)");
+    auto* seed = new G4UIparameter("seed", 'l', false);
+    seed->SetParameterRange("seed>=0");
+    fMasterSeedCmd->SetParameter(seed);
+
+    fFirstEventCmd = new G4UIcommand("/random/setFirstEvent", this);
+    fFirstEventCmd->SetGuidance("Global number of the first event of this job");
+    auto* first = new G4UIparameter("first", 'l', false);
+    first->SetParameterRange("first>=0");
+    fFirstEventCmd->SetParameter(first);
+  }
+  ~SeedMessenger() override {
+    delete fMasterSeedCmd;
+    delete fFirstEventCmd;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fMasterSeedCmd)
+      EventSeeder::SetMasterSeed(G4UIcommand::ConvertToLongInt(val));
+    else if (cmd == fFirstEventCmd)
+      EventSeeder::SetFirstEvent(G4UIcommand::ConvertToLongInt(val));
+  }
+private:
+  G4UIcommand* fMasterSeedCmd;
+  G4UIcommand* fFirstEventCmd;
+};
+
+/**
+ * @brief Create the /random/ commands (once)
+ */
+void EventSeeder::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new SeedMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Set the master seed
+ * @param seed Master seed; 0 switches per-event seeding off
+ */
+void EventSeeder::SetMasterSeed(G4long seed)
+{
+  fMasterSeed = seed;
+  if (seed != 0) {
+    RunAction::SetMetadata("master_seed", std::to_string(seed));
+  } else {
+    RunAction::RemoveMetadata("master_seed");
+  }
+}
+
+/**
+ * @brief Set the global number of the first event of this job
+ * @param first Number of the first event
+ */
+void EventSeeder::SetFirstEvent(G4long first)
+{
+  fFirstEvent = first;
+  RunAction::SetMetadata("first_event", std::to_string(first));
+}
+
+/**
+ * @brief 64-bit finaliser of SplitMix64
+ * @param x Value to mix
+ * @return Well-mixed hash of x
+ */
+uint64_t EventSeeder::Mix(uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Reseed the engine for an event
+ * @param runID Run the event belongs to
+ * @param eventID Event ID within the run
+ * @details Does nothing without a master seed.  The two 31-bit seeds are the
+ *          halves of hash(hash(hash(master) + run) + global event number).
+ */
+void EventSeeder::SeedEvent(G4int runID, G4int eventID)
+{
+  if (fMasterSeed == 0) return;
+
+  SetSeeds(Mix(Mix(Mix(uint64_t(fMasterSeed)) + uint64_t(runID)) + uint64_t(GlobalEventID(eventID))));
+}
+
+/**
+ * @brief Reseed the engine for a per-run task outside the events
+ * @param runID Run the task belongs to
+ * @param stream Task number
+ * @details Does nothing without a master seed.  The extra Mix() keeps the
+ *          seeds apart from those of the events of the run.
+ */
+void EventSeeder::SeedRunTask(G4int runID, uint64_t stream)
+{
+  if (fMasterSeed == 0) return;
+
+  SetSeeds(Mix(Mix(Mix(Mix(uint64_t(fMasterSeed)) + uint64_t(runID))) + stream));
+}
+
+/**
+ * @brief Set the engine seeds from a hash
+ * @param hash 64-bit hash; its halves give the two 31-bit seeds
+ */
+void EventSeeder::SetSeeds(uint64_t hash)
+{
+  long seeds[3] = {long(hash & 0x7fffffff), long((hash >> 32) & 0x7fffffff), 0};
+  // A zero would end the seed list
+  if (seeds[0] == 0) seeds[0] = 1;
+  if (seeds[1] == 0) seeds[1] = 1;
+  G4Random::setTheSeeds(seeds);
+}
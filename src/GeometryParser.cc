@@ -1,7 +1,12 @@
 #include "GeometryParser.hh"
 #include "G4NistManager.hh"
 #include "G4SDManager.hh"
-#include "MySensitiveDetector.hh"
+#include "SensitiveDetectorFactory.hh"
+#include "G4VSensitiveDetector.hh"
+#include "PlacementParameterisation.hh"
+#include "PhaseSpaceWriter.hh"
+#include "ImportanceBiasing.hh"
+#include "RegionStepLimiter.hh"
 
 // Basic shapes
 #include "G4Box.hh"
@@ -29,12 +34,31 @@
 #include "G4AssemblyVolume.hh"
 #include "G4VisAttributes.hh"
 
+// Regions
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4UserLimits.hh"
+
+// Navigation
+#include "G4LogicalVolumeStore.hh"
+#include "G4GeometryManager.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelProxy.hh"
+#include "G4SmartVoxelNode.hh"
+
 #include "G4SystemOfUnits.hh"
 #include "G4PhysicalConstants.hh"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <map>
 #include <stdexcept>
 #include <filesystem>
+#include <functional>
 #include <unordered_set>
 
 namespace fs = std::filesystem;
@@ -61,14 +85,334 @@ GeometryParser::~GeometryParser()
  *          and stores the config path for loading external files
  */
 void GeometryParser::LoadGeometryConfig(const std::string& filename) {
+    geometryConfig = ReadJsonFile(filename);
+    
+    // Store the directory path for loading external files
+    configPath = fs::path(filename).parent_path().string();
+}
+
+/**
+ * @brief Use an already parsed geometry configuration
+ * @param config Geometry configuration (e.g. a patched variant of a file)
+ * @param filename Path the configuration belongs to; external files are resolved relative to it
+ */
+void GeometryParser::LoadGeometryConfig(const json& config, const std::string& filename) {
+    geometryConfig = config;
+    configPath = fs::path(filename).parent_path().string();
+}
+
+/**
+ * @brief Read and parse a JSON file
+ * @param filename Path to the file
+ * @return Parsed JSON document
+ * @throws std::runtime_error if the file cannot be opened
+ */
+json GeometryParser::ReadJsonFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open geometry config file: " + filename);
     }
-    file >> geometryConfig;
-    
-    // Store the directory path for loading external files
-    configPath = fs::path(filename).parent_path().string();
+    json config;
+    file >> config;
+    return config;
+}
+
+/**
+ * @brief Forget all geometry built so far and free the objects owned by the parser
+ * @details The Geant4 stores own the solids, logical and physical volumes and assemblies;
+ *          they must have been cleaned before this is called.  Rotations, visualization
+ *          attributes and parameterisations are owned here and deleted.  Materials are kept.
+ */
+void GeometryParser::ClearGeometry() {
+    volumes.clear();
+    logicalVolumeMap.clear();
+    solids.clear();
+    assemblies.clear();
+    assemblyEnvelopes.clear();
+    importPrototypes.clear();
+    importedMaterials = json();
+    copyNumbers.clear();
+    placementVolumes.clear();
+    placementRotations.clear();
+    visAttributes.clear();
+    parameterisations.clear();
+
+    // The regions still list the deleted root volumes; a region dropped from the
+    // JSON must not stay active, and the next construction creates them afresh.
+    // Their cuts are kept for reuse, the couple table still points to them.
+    for (G4Region* region : regions) {
+        delete region->GetUserLimits();
+        delete region;
+    }
+    regions.clear();
+    worldPhysical = nullptr;
+}
+
+namespace {
+
+/// True if a boolean solid anywhere in the config refers to a volume's solid by name
+bool NamesSolid(const json& node, const std::string& name) {
+    if (node.is_object()) {
+        for (const char* key : {"solid1", "solid2"}) {
+            if (node.contains(key) && node[key].is_string() && node[key].get<std::string>() == name) {
+                return true;
+            }
+        }
+    }
+    if (node.is_structured()) {
+        for (const auto& child : node) {
+            if (NamesSolid(child, name)) return true;
+        }
+    }
+    return false;
+}
+
+/// True if a placement is generated by a parameterised pattern (inside an envelope)
+bool IsEnvelopePattern(const json& placement) {
+    return placement.contains("pattern") && placement["pattern"].contains("parameterised") &&
+           placement["pattern"]["parameterised"].get<bool>();
+}
+
+/**
+ * True if an envelope was sized from, or filled with the material of, a volume:
+ * the volume is placed by a parameterised pattern or is a component of an
+ * envelope assembly (size), or it is the parent of such a placement (material).
+ * Envelopes are built once and not resized or refilled by an in-place update.
+ */
+bool ShapesEnvelope(const json& volumeConfigs, const std::string& name, bool inEnvelope = false) {
+    for (const auto& volConfig : volumeConfigs) {
+        const bool isAssembly = volConfig.contains("type") && volConfig["type"] == "assembly";
+        const bool envelope = inEnvelope || (isAssembly && volConfig.contains("envelope"));
+        const bool named = volConfig.contains("name") && volConfig["name"] == name;
+        if (envelope && named) return true;
+        if (volConfig.contains("placements")) {
+            for (const auto& placement : volConfig["placements"]) {
+                if (!IsEnvelopePattern(placement) && !(isAssembly && envelope)) continue;
+                if (named) return true;
+                if (placement.contains("parent") && placement["parent"] == name) return true;
+            }
+        }
+        if (isAssembly && volConfig.contains("components") &&
+            ShapesEnvelope(volConfig["components"], name, envelope)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief Apply the differences between the loaded and a new geometry file in place
+ * @param filename Path to the new geometry JSON file
+ * @param materialsChanged Set to true if a logical volume changed material
+ * @return true if the changes were applied, false if a full rebuild is needed
+ * @throws std::runtime_error if the file cannot be opened or parsed
+ * @details The new configuration is first compared volume by volume against the loaded
+ *          one.  Only if every difference can be applied to the existing objects is the
+ *          geometry opened and modified: moved placements get a new translation and
+ *          rotation, changed dimensions a new solid (the old one is deleted), changed
+ *          materials and visualization settings are set on the existing logical volume.
+ *          Solids referenced by a boolean, and volumes an envelope was sized from or
+ *          filled with (parameterised patterns, envelope assemblies), need a rebuild.
+ */
+G4bool GeometryParser::UpdateGeometry(const std::string& filename, G4bool& materialsChanged) {
+    return UpdateGeometry(ReadJsonFile(filename), filename, materialsChanged);
+}
+
+/**
+ * @brief Apply the differences to an already parsed configuration in place
+ * @param newConfig New geometry configuration
+ * @param filename Path the new configuration belongs to
+ * @param materialsChanged Set to true if a logical volume changed material
+ * @return true if the changes were applied, false if a full rebuild is needed
+ */
+G4bool GeometryParser::UpdateGeometry(const json& newConfig, const std::string& filename, G4bool& materialsChanged) {
+    materialsChanged = false;
+    if (!worldPhysical) {
+        return false;
+    }
+
+    auto section = [](const json& config, const char* key) {
+        return config.contains(key) ? config[key] : json();
+    };
+    auto fallback = [](const std::string& reason) {
+        G4cout << "GeometryParser::UpdateGeometry() - Full rebuild needed: " << reason << G4endl;
+        return false;
+    };
+
+    if (fs::path(filename).parent_path().string() != configPath) {
+        return fallback("configuration directory changed");
+    }
+    if (section(newConfig, "world") != section(geometryConfig, "world")) {
+        return fallback("world changed");
+    }
+    if (section(newConfig, "regions") != section(geometryConfig, "regions")) {
+        return fallback("regions changed");
+    }
+
+    // Materials that have been built cannot be redefined in place
+    json oldMaterials = section(geometryConfig, "materials");
+    json newMaterials = section(newConfig, "materials");
+    for (auto it = newMaterials.begin(); it != newMaterials.end(); ++it) {
+        if (materials.find(it.key()) != materials.end() &&
+            (!oldMaterials.contains(it.key()) || oldMaterials[it.key()] != it.value())) {
+            return fallback("material " + it.key() + " redefined");
+        }
+    }
+
+    // Compare volume by volume; only some keys may change
+    static const std::unordered_set<std::string> updatableKeys = {
+        "placements", "dimensions", "material", "visible", "wireframe", "smartless", "optimise"
+    };
+    static const std::unordered_set<std::string> booleanTypes = {
+        "union", "subtraction", "intersection"
+    };
+    json oldVolumes = section(geometryConfig, "volumes");
+    json newVolumes = section(newConfig, "volumes");
+    if (oldVolumes.size() != newVolumes.size()) {
+        return fallback("volumes added or removed");
+    }
+    std::vector<size_t> changed;
+    for (size_t i = 0; i < newVolumes.size(); i++) {
+        const json& oldVolume = oldVolumes[i];
+        const json& newVolume = newVolumes[i];
+        if (oldVolume == newVolume) continue;
+
+        std::string name = section(oldVolume, "name").is_string() ? oldVolume["name"].get<std::string>() : "";
+        if (section(newVolume, "name") != section(oldVolume, "name") ||
+            section(newVolume, "type") != section(oldVolume, "type")) {
+            return fallback("volume " + std::to_string(i) + " renamed or retyped");
+        }
+        std::string type = newVolume["type"].get<std::string>();
+        if (type == "assembly" || newVolume.contains("external_file") ||
+            volumes.find(name) == volumes.end()) {
+            return fallback(name + " is not a regular volume");
+        }
+
+        std::unordered_set<std::string> keys;
+        for (auto it = oldVolume.begin(); it != oldVolume.end(); ++it) keys.insert(it.key());
+        for (auto it = newVolume.begin(); it != newVolume.end(); ++it) keys.insert(it.key());
+        for (const auto& key : keys) {
+            if (section(oldVolume, key.c_str()) == section(newVolume, key.c_str())) continue;
+            if (updatableKeys.count(key) == 0) {
+                return fallback(name + ": " + key + " changed");
+            }
+            if (key == "dimensions" && booleanTypes.count(type) > 0) {
+                return fallback(name + ": boolean solid changed");
+            }
+            // The old solid is deleted, and booleans may hold it by name
+            if (key == "dimensions" && NamesSolid(geometryConfig, name)) {
+                return fallback(name + ": solid used by a boolean solid");
+            }
+            if ((key == "dimensions" || key == "material") &&
+                ShapesEnvelope(section(geometryConfig, "volumes"), name)) {
+                return fallback(name + ": " + key + " of a pattern or assembly envelope changed");
+            }
+        }
+
+        // Placements may only move or turn
+        json oldPlacements = section(oldVolume, "placements");
+        json newPlacements = section(newVolume, "placements");
+        if (oldPlacements != newPlacements) {
+            if (oldPlacements.size() != newPlacements.size()) {
+                return fallback(name + ": placements added or removed");
+            }
+            const auto& placed = placementVolumes[name];
+            for (size_t j = 0; j < newPlacements.size(); j++) {
+                if (oldPlacements[j] == newPlacements[j]) continue;
+                json oldFixed = oldPlacements[j];
+                json newFixed = newPlacements[j];
+                for (const char* key : {"x", "y", "z", "rotation"}) {
+                    oldFixed.erase(key);
+                    newFixed.erase(key);
+                }
+                if (oldFixed != newFixed || oldFixed.contains("pattern") ||
+                    j >= placed.size() || placed[j] == nullptr) {
+                    return fallback(name + ": placement " + std::to_string(j) + " changed beyond position/rotation");
+                }
+            }
+        }
+        changed.push_back(i);
+    }
+
+    // Everything can be updated in place
+    geometryConfig = newConfig;
+    G4GeometryManager::GetInstance()->OpenGeometry();
+
+    for (size_t i : changed) {
+        const json& oldVolume = oldVolumes[i];
+        const json& newVolume = newVolumes[i];
+        std::string name = newVolume["name"].get<std::string>();
+        G4LogicalVolume* logicalVolume = volumes[name];
+        G4cout << "GeometryParser::UpdateGeometry() - Updating " << name << G4endl;
+
+        if (section(oldVolume, "dimensions") != section(newVolume, "dimensions")) {
+            G4VSolid* oldSolid = logicalVolume->GetSolid();
+            solids.erase(name);
+            logicalVolume->SetSolid(CreateSolid(newVolume, name));
+            delete oldSolid;
+        }
+
+        if (section(oldVolume, "material") != section(newVolume, "material")) {
+            std::string matName = newVolume.contains("material") ?
+                                  newVolume["material"].get<std::string>() : "G4_AIR";
+            G4Material* material = nullptr;
+            if (materials.find(matName) != materials.end()) {
+                material = materials[matName];
+            } else if (!newVolume.contains("material")) {
+                material = G4NistManager::Instance()->FindOrBuildMaterial(matName);
+            } else {
+                json matConfig = FindMaterialConfig(matName);
+                if (matConfig.empty()) {
+                    throw std::runtime_error("Material not defined: " + matName);
+                }
+                material = CreateMaterial(matName, matConfig);
+            }
+            logicalVolume->SetMaterial(material);
+            materialsChanged = true;
+        }
+
+        if (section(oldVolume, "material") != section(newVolume, "material") ||
+            section(oldVolume, "visible") != section(newVolume, "visible") ||
+            section(oldVolume, "wireframe") != section(newVolume, "wireframe")) {
+            logicalVolume->SetVisAttributes(nullptr);
+            ApplyVisualizationAttributes(logicalVolume, newVolume);
+        }
+
+        if (newVolume.contains("smartless")) {
+            logicalVolume->SetSmartless(newVolume["smartless"].get<double>());
+        }
+        if (newVolume.contains("optimise")) {
+            logicalVolume->SetOptimisation(newVolume["optimise"].get<bool>());
+        }
+
+        json oldPlacements = section(oldVolume, "placements");
+        json newPlacements = section(newVolume, "placements");
+        const auto& placed = placementVolumes[name];
+        for (size_t j = 0; j < newPlacements.size() && oldPlacements != newPlacements; j++) {
+            if (oldPlacements[j] == newPlacements[j]) continue;
+            G4ThreeVector position;
+            G4RotationMatrix* rotation = nullptr;
+            ParsePlacement(newPlacements[j], position, rotation);
+
+            G4VPhysicalVolume* physical = placed[j];
+            const G4RotationMatrix* oldRotation = physical->GetRotation();
+            physical->SetTranslation(position);
+            physical->SetRotation(rotation);
+            placementRotations.emplace_back(rotation);
+            for (auto& owned : placementRotations) {
+                if (owned && owned.get() == oldRotation) {
+                    owned.reset();
+                    break;
+                }
+            }
+        }
+    }
+
+    G4cout << "GeometryParser::UpdateGeometry() - Updated " << changed.size()
+           << " volume(s) in place" << G4endl;
+    return true;
 }
 
 /**
@@ -242,6 +586,22 @@ void GeometryParser::ParsePlacement(const json& placement, G4ThreeVector& positi
     }
 }
 
+/**
+ * @brief Look up the JSON definition of a material
+ * @param name Material name
+ * @return Definition from the main configuration or an imported file, empty object if unknown
+ * @details The main configuration takes precedence over materials brought in by imports
+ */
+json GeometryParser::FindMaterialConfig(const std::string& name) const {
+    if (geometryConfig.contains("materials") && geometryConfig["materials"].contains(name)) {
+        return geometryConfig["materials"][name];
+    }
+    if (importedMaterials.contains(name)) {
+        return importedMaterials[name];
+    }
+    return json::object();
+}
+
 /**
  * @brief Create a G4LogicalVolume from JSON configuration
  * @param config JSON object containing volume properties
@@ -300,7 +660,11 @@ G4LogicalVolume* GeometryParser::CreateVolume(const json& config) {
         std::string mat_name = config["material"].get<std::string>();
         
         if (materials.find(mat_name) == materials.end()) {
-            material = CreateMaterial(mat_name, geometryConfig["materials"][mat_name]);
+            json matConfig = FindMaterialConfig(mat_name);
+            if (matConfig.empty()) {
+                throw std::runtime_error("Material not defined: " + mat_name);
+            }
+            material = CreateMaterial(mat_name, matConfig);
 //
 //            material = CreateMaterial(mat_name, materialsConfig["materials"][mat_name]);
         } else {
@@ -323,6 +687,14 @@ G4LogicalVolume* GeometryParser::CreateVolume(const json& config) {
     
     // Apply visualization attributes
     ApplyVisualizationAttributes(logicalVolume, config);
+
+    // Navigation voxelisation tuning for mothers with many daughters
+    if (config.contains("smartless")) {
+        logicalVolume->SetSmartless(config["smartless"].get<double>());
+    }
+    if (config.contains("optimise")) {
+        logicalVolume->SetOptimisation(config["optimise"].get<bool>());
+    }
     
     volumes[name] = logicalVolume;
     logicalVolumeMap[name + "_logical"] = logicalVolume;
@@ -342,10 +714,10 @@ void GeometryParser::ApplyVisualizationAttributes(G4LogicalVolume* logicalVolume
     // Set visualization attributes based on material color if available
     if (config.contains("material")) {
         std::string mat_name = config["material"].get<std::string>();
-        if (geometryConfig["materials"].contains(mat_name) && 
-            geometryConfig["materials"][mat_name].contains("color")) {
+        json matConfig = FindMaterialConfig(mat_name);
+        if (matConfig.contains("color")) {
             
-            const auto& colorArray = geometryConfig["materials"][mat_name]["color"];
+            const auto& colorArray = matConfig["color"];
             if (colorArray.size() >= 3) {
                 G4double r = colorArray[0].get<double>();
                 G4double g = colorArray[1].get<double>();
@@ -353,6 +725,7 @@ void GeometryParser::ApplyVisualizationAttributes(G4LogicalVolume* logicalVolume
                 G4double a = (colorArray.size() >= 4) ? colorArray[3].get<double>() : 1.0;
                 
                 G4VisAttributes* visAttr = new G4VisAttributes(G4Colour(r, g, b, a));
+                visAttributes.emplace_back(visAttr);
                 
                 // Set wireframe if specified in the volume config
                 if (config.contains("wireframe") && config["wireframe"].get<bool>()) {
@@ -374,6 +747,7 @@ void GeometryParser::ApplyVisualizationAttributes(G4LogicalVolume* logicalVolume
     // Handle visibility even if no material color is specified
     if (!logicalVolume->GetVisAttributes()) {
         G4VisAttributes* defaultVisAttr = new G4VisAttributes(G4Colour(0.5, 0.5, 0.5, 1.0));
+        visAttributes.emplace_back(defaultVisAttr);
         
         // Set wireframe if specified in the volume config
         if (config.contains("wireframe") && config["wireframe"].get<bool>()) {
@@ -400,10 +774,12 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
     G4cout << "GeometryParser::ConstructGeometry() - Creating world volume" << G4endl;
     G4LogicalVolume* worldLV = CreateVolume(geometryConfig["world"]);    
     auto worldVis = new G4VisAttributes();
+    visAttributes.emplace_back(worldVis);
     worldVis->SetVisibility(false);
     worldLV->SetVisAttributes(worldVis);
     G4VPhysicalVolume* worldPV = new G4PVPlacement(
         nullptr, G4ThreeVector(), worldLV, "World", nullptr, false, 0);
+    worldPhysical = worldPV;
     G4cout << "GeometryParser::ConstructGeometry() - Created world physical volume" << G4endl;
     
     // Store the world volume in our volumes map for parent references
@@ -426,6 +802,11 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
             G4cout << "GeometryParser::ConstructGeometry() - Skipping assembly volume" << G4endl;
             continue;
         }
+
+        // Imported geometries are built once from their own file, see ImportAssembledGeometry()
+        if (volConfig.contains("external_file")) {
+            continue;
+        }
         
         if (!volConfig.contains("name")) {
             G4cerr << "Error: name key not found in volume " << i << G4endl;
@@ -445,9 +826,9 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
         }
     }
 
-    // Create all assemblies before placement
+    // Create all assemblies before placement (envelope assemblies are built when placed)
     for (const auto& volConfig : geometryConfig["volumes"]) {
-        if (volConfig["type"].get<std::string>() == "assembly") {
+        if (volConfig["type"].get<std::string>() == "assembly" && !volConfig.contains("envelope")) {
             CreateAssembly(volConfig);
         }
     }
@@ -459,11 +840,16 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
     // Second pass: First place volumes with World as parent
     for (const auto& volConfig : geometryConfig["volumes"]) {
         if (volConfig["type"].get<std::string>() == "assembly") continue;
+        if (volConfig.contains("external_file")) continue;
 
         G4cout << "GeometryParser::ConstructGeometry() - Placing volume " << volConfig["name"].get<std::string>() << G4endl;
 
         std::string name = volConfig["name"].get<std::string>();        
         G4LogicalVolume* logicalVolume = volumes[name];
+
+        // Physical volume of each placement, used for incremental updates
+        std::vector<G4VPhysicalVolume*>& placed = placementVolumes[name];
+        placed.clear();
         
         // Skip if no placements array
         if (!volConfig.contains("placements") || volConfig["placements"].empty()) {
@@ -473,6 +859,8 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
         
         // Process each placement - only those with World as parent in this pass
         for (const auto& placement : volConfig["placements"]) {
+            placed.push_back(nullptr);
+
             // Get parent volume
             std::string parentName = "World"; // Default to world if no parent specified
             if (placement.contains("parent")) {
@@ -489,6 +877,7 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
             // Check if parent exists
             if (volumes.find(parentName) == volumes.end()) {
                 G4cerr << "Error: Parent volume " << parentName << " not found for " << name << G4endl;
+                delete rotation;
                 continue;
             }
             
@@ -510,11 +899,20 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
             }
             
             // Track copy number per logical volume per mother
-            static std::map<std::pair<std::string,std::string>, int> copyCounter;
             auto key = std::make_pair(name, parentName);
-            int copyNo = copyCounter[key]++;
-            
-            new G4PVPlacement(
+
+            // Placement generators expand into many copies of the same volume
+            if (placement.contains("pattern")) {
+                delete rotation;
+                copyNumbers[key] += PlacePattern(placement, logicalVolume, placementName,
+                                                 parentVolume, copyNumbers[key]);
+                continue;
+            }
+
+            int copyNo = copyNumbers[key]++;
+
+            placementRotations.emplace_back(rotation);
+            placed.back() = new G4PVPlacement(
                 rotation,           // rotation
                 position,           // position
                 logicalVolume,      // logical volume
@@ -529,6 +927,17 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
         }
     }
 
+    // Place all imported geometries
+    for (const auto& volConfig : geometryConfig["volumes"]) {
+        if (!volConfig.contains("external_file")) continue;
+        try {
+            ImportAssembledGeometry(volConfig);
+        } catch (const std::exception& e) {
+            G4cerr << "GeometryParser::ConstructGeometry() - Error importing "
+                   << volConfig["external_file"].get<std::string>() << ": " << e.what() << G4endl;
+        }
+    }
+
     // Place all assemblies
     for (const auto& volConfig : geometryConfig["volumes"]) {
         // Skip non-assembly volumes
@@ -539,6 +948,41 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
         
         // Get the assembly name
         std::string assemblyName = volConfig["name"].get<std::string>();
+
+        // Envelope mode: place a real mother volume holding the components
+        if (volConfig.contains("envelope")) {
+            if (!volConfig.contains("placements")) continue;
+            int iEnvelope = 0;
+            for (const auto& placement : volConfig["placements"]) {
+                std::string parentName = placement.contains("parent") ?
+                                         placement["parent"].get<std::string>() : "World";
+                if (volumes.find(parentName) == volumes.end()) {
+                    G4cerr << "Error: Parent volume " << parentName << " not found for assembly " << assemblyName << G4endl;
+                    continue;
+                }
+                G4LogicalVolume* parentVolume = volumes[parentName];
+                try {
+                    const AssemblyEnvelope& envelope = BuildAssemblyEnvelope(
+                        volConfig, parentVolume->GetMaterial(), volConfig["envelope"].get<std::string>());
+
+                    // The envelope origin sits at the envelope centre, not at the assembly origin
+                    G4Transform3D transform = ParseAssemblyTransform(placement);
+                    G4Transform3D envelopeTransform(transform.getRotation(),
+                                                    transform.getTranslation() + transform.getRotation() * envelope.centre);
+                    std::string placementName = placement.contains("name") ?
+                                                placement["name"].get<std::string>() : assemblyName;
+                    G4cout << "GeometryParser::ConstructGeometry() - Placing assembly envelope " << placementName
+                           << " in " << parentName << " at position " << envelopeTransform.getTranslation() << G4endl;
+                    new G4PVPlacement(envelopeTransform, envelope.logical, placementName, parentVolume,
+                                      false, iEnvelope++);
+                } catch (const std::exception& e) {
+                    G4cerr << "GeometryParser::ConstructGeometry() - Error building envelope for assembly "
+                           << assemblyName << ": " << e.what() << G4endl;
+                }
+            }
+            continue;
+        }
+
         G4AssemblyVolume* assembly = assemblies[assemblyName];
         
         if (!assembly) {
@@ -587,15 +1031,360 @@ G4VPhysicalVolume* GeometryParser::ConstructGeometry() {
                    << " at position " << position << G4endl;
             
             assembly->MakeImprint(parentVolume, position, rotation, iCopy++, false);
+            delete rotation;  // MakeImprint copies the transformation
         }
     }
     
     // Setup sensitive detectors for active volumes
     SetupSensitiveDetectors();
-    
+
+    // Regions with their own production cuts and user limits
+    SetupRegions();
+
+    // Phase-space record surfaces
+    SetupRecordSurfaces();
+
+    // Importance biasing
+    SetupImportances();
+
+    // Mother volumes that dominate navigation cost, if the geometry asks for them:
+    // "navigation_report": true, or the minimum number of daughters
+    if (geometryConfig.contains("navigation_report")) {
+        const json& report = geometryConfig["navigation_report"];
+        if (report.is_number_integer()) {
+            ReportNavigation(report.get<int>());
+        } else if (report.is_boolean() && report.get<bool>()) {
+            ReportNavigation();
+        }
+    }
+
     return worldPV;
 }
 
+namespace {
+
+/// Summary of a smart-voxel tree
+struct VoxelStats {
+    G4int  headers      = 0;  ///< Number of voxel headers (all refinement levels)
+    G4int  nodes        = 0;  ///< Number of distinct voxel nodes
+    G4int  depth        = 0;  ///< Deepest refinement level
+    size_t maxContained = 0;  ///< Largest number of daughters in one node
+    size_t sumContained = 0;  ///< Sum of daughters over all nodes
+};
+
+/// Walk a voxel header recursively; equivalent slices share one proxy
+void CollectVoxelStats(const G4SmartVoxelHeader* header, VoxelStats& stats, G4int depth) {
+    stats.headers++;
+    stats.depth = std::max(stats.depth, depth);
+    const G4SmartVoxelProxy* previous = nullptr;
+    for (size_t i = 0; i < header->GetNoSlices(); i++) {
+        const G4SmartVoxelProxy* proxy = header->GetSlice(i);
+        if (proxy == previous) continue;
+        previous = proxy;
+        if (proxy->IsHeader()) {
+            CollectVoxelStats(proxy->GetHeader(), stats, depth + 1);
+        } else {
+            size_t contained = proxy->GetNode()->GetNoContained();
+            stats.nodes++;
+            stats.sumContained += contained;
+            stats.maxContained = std::max(stats.maxContained, contained);
+        }
+    }
+}
+
+const char* AxisName(EAxis axis) {
+    switch (axis) {
+        case kXAxis:     return "x";
+        case kYAxis:     return "y";
+        case kZAxis:     return "z";
+        case kRho:       return "rho";
+        case kRadial3D:  return "r3d";
+        case kPhi:       return "phi";
+        default:         return "-";
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Print daughter counts and voxel statistics of all mother volumes
+ * @param minDaughters Only volumes with at least this many daughters are listed
+ * @details Volumes are sorted by daughter count.  Once the geometry is closed the
+ *          navigator's own voxels are reported; while it is open (at construction,
+ *          or after a rebuild before the next run) they are built temporarily for
+ *          the report.  A large "max/node" value means many daughters are tested at
+ *          every step in that region; raising "smartless" on the mother refines the
+ *          voxels there.
+ */
+void GeometryParser::ReportNavigation(G4int minDaughters) const {
+    std::vector<G4LogicalVolume*> mothers;
+    for (auto* lv : *G4LogicalVolumeStore::GetInstance()) {
+        if (lv->GetNoDaughters() >= static_cast<size_t>(std::max(1, minDaughters))) {
+            mothers.push_back(lv);
+        }
+    }
+    std::sort(mothers.begin(), mothers.end(), [](G4LogicalVolume* a, G4LogicalVolume* b) {
+        return a->GetNoDaughters() > b->GetNoDaughters();
+    });
+
+    G4cout << "GeometryParser::ReportNavigation() - " << mothers.size()
+           << " mother volume(s) with >= " << minDaughters << " daughters" << G4endl;
+    if (mothers.empty()) return;
+
+    G4cout << std::left << std::setw(32) << "  Volume" << std::right
+           << std::setw(10) << "daughters" << std::setw(10) << "smartless"
+           << std::setw(9) << "optimise" << std::setw(6) << "axis"
+           << std::setw(8) << "slices" << std::setw(8) << "nodes"
+           << std::setw(7) << "depth" << std::setw(10) << "max/node"
+           << std::setw(11) << "mean/node" << G4endl;
+
+    for (auto* lv : mothers) {
+        G4cout << "  " << std::left << std::setw(30) << lv->GetName() << std::right
+               << std::setw(10) << lv->GetNoDaughters()
+               << std::setw(10) << lv->GetSmartless()
+               << std::setw(9) << (lv->IsToOptimise() ? "yes" : "no");
+
+        // Use the navigator's voxels if the geometry is closed, otherwise build them
+        const G4SmartVoxelHeader* header = lv->GetVoxelHeader();
+        G4SmartVoxelHeader* temporary = nullptr;
+        if (!header && lv->IsToOptimise()) {
+            temporary = new G4SmartVoxelHeader(lv);
+            header = temporary;
+        }
+
+        if (header) {
+            VoxelStats stats;
+            CollectVoxelStats(header, stats, 0);
+            G4double mean = stats.nodes ? static_cast<G4double>(stats.sumContained) / stats.nodes : 0;
+            G4cout << std::setw(6) << AxisName(header->GetAxis())
+                   << std::setw(8) << header->GetNoSlices()
+                   << std::setw(8) << stats.nodes
+                   << std::setw(7) << stats.depth
+                   << std::setw(10) << stats.maxContained
+                   << std::setw(11) << std::setprecision(3) << mean << std::setprecision(6);
+        } else {
+            G4cout << "  (not voxelised)";
+        }
+        G4cout << G4endl;
+
+        delete temporary;
+    }
+}
+
+/**
+ * @brief Generate the copy offsets of a placement pattern
+ * @param pattern JSON object with the pattern type and its parameters
+ * @param offsets Filled with the offset of each copy relative to the placement origin
+ * @param phis Filled with the extra rotation about z of each copy (rotated rings only)
+ * @throws std::runtime_error if the pattern type is unknown or parameters are invalid
+ * @details Supported patterns (lengths in mm, angles in radians):
+ *          - linear: "count", "step" {x,y,z}
+ *          - grid:   "nx", "ny", optional "nz", "pitch" {x,y,z}; centred on the origin
+ *          - ring:   "count", "radius", optional "start_phi", "delta_phi", "rotate"
+ *          - hex:    "pitch", and "rings" and/or "max_radius"; hexagonal lattice in the x-y plane
+ */
+void GeometryParser::GeneratePatternOffsets(const json& pattern, std::vector<G4ThreeVector>& offsets,
+                                            std::vector<G4double>& phis) {
+    offsets.clear();
+    phis.clear();
+
+    if (!pattern.contains("type")) {
+        throw std::runtime_error("Missing type key in placement pattern");
+    }
+    std::string type = pattern["type"].get<std::string>();
+
+    if (type == "linear") {
+        int count = pattern["count"].get<int>();
+        G4ThreeVector step = ParseVector(pattern["step"]);
+        for (int i = 0; i < count; i++) {
+            offsets.push_back(i * step);
+        }
+    }
+    else if (type == "grid") {
+        int nx = pattern["nx"].get<int>();
+        int ny = pattern["ny"].get<int>();
+        int nz = pattern.contains("nz") ? pattern["nz"].get<int>() : 1;
+        G4ThreeVector pitch = ParseVector(pattern["pitch"]);
+        for (int iz = 0; iz < nz; iz++) {
+            for (int iy = 0; iy < ny; iy++) {
+                for (int ix = 0; ix < nx; ix++) {
+                    offsets.push_back(G4ThreeVector((ix - 0.5 * (nx - 1)) * pitch.x(),
+                                                    (iy - 0.5 * (ny - 1)) * pitch.y(),
+                                                    (iz - 0.5 * (nz - 1)) * pitch.z()));
+                }
+            }
+        }
+    }
+    else if (type == "ring") {
+        int count = pattern["count"].get<int>();
+        G4double radius = pattern["radius"].get<double>() * mm;
+        G4double sphi = pattern.contains("start_phi") ? pattern["start_phi"].get<double>() * rad : 0;
+        G4double dphi = pattern.contains("delta_phi") ? pattern["delta_phi"].get<double>() * rad : 2 * M_PI * rad;
+        bool rotate = pattern.contains("rotate") && pattern["rotate"].get<bool>();
+
+        // A full circle spaces copies by dphi/count, an arc puts copies on both ends
+        bool fullCircle = std::abs(dphi - 2 * M_PI) < 1e-9;
+        G4double spacing = fullCircle ? dphi / count : (count > 1 ? dphi / (count - 1) : 0);
+        for (int i = 0; i < count; i++) {
+            G4double phi = sphi + i * spacing;
+            offsets.push_back(G4ThreeVector(radius * std::cos(phi), radius * std::sin(phi), 0));
+            phis.push_back(rotate ? phi : 0);
+        }
+    }
+    else if (type == "hex") {
+        G4double pitch = pattern["pitch"].get<double>() * mm;
+        G4double maxRadius = pattern.contains("max_radius") ? pattern["max_radius"].get<double>() * mm : 0;
+        if (!pattern.contains("rings") && maxRadius <= 0) {
+            throw std::runtime_error("Hex placement pattern needs 'rings' or 'max_radius'");
+        }
+        G4double rowPitch = pitch * std::sqrt(3.) / 2;
+        int rings = pattern.contains("rings") ? pattern["rings"].get<int>()
+                                              : static_cast<int>(std::ceil(maxRadius / rowPitch)) + 1;
+
+        // Axial lattice coordinates (q, r) within the given number of hexagonal rings
+        for (int q = -rings; q <= rings; q++) {
+            for (int r = std::max(-rings, -q - rings); r <= std::min(rings, -q + rings); r++) {
+                G4ThreeVector offset(pitch * (q + 0.5 * r), rowPitch * r, 0);
+                if (maxRadius > 0 && offset.perp() > maxRadius) continue;
+                offsets.push_back(offset);
+            }
+        }
+
+        // Number the copies row by row
+        std::sort(offsets.begin(), offsets.end(), [](const G4ThreeVector& a, const G4ThreeVector& b) {
+            return (a.y() != b.y()) ? a.y() < b.y() : a.x() < b.x();
+        });
+    }
+    else {
+        throw std::runtime_error("Unsupported placement pattern type: " + type);
+    }
+
+    phis.resize(offsets.size(), 0);
+}
+
+/**
+ * @brief Place all copies described by a placement with a "pattern" entry
+ * @param placement JSON placement object containing the pattern
+ * @param logicalVolume Logical volume to place
+ * @param placementName Base name for the physical volume(s)
+ * @param parentVolume Mother logical volume
+ * @param firstCopyNo Copy number of the first generated copy
+ * @return Number of copies placed
+ * @details The placement's x/y/z give the pattern origin and its rotation orients every
+ *          copy.  By default each copy becomes its own G4PVPlacement named
+ *          <placementName>_<i>.  With "parameterised": true the copies are represented by a
+ *          single G4PVParameterised (copy numbers 0..N-1).  Because a parameterised volume
+ *          must be the only daughter of its mother, it is wrapped in an envelope filled with
+ *          the parent's material: a tube around the ring axis for ring patterns, otherwise
+ *          the bounding box of all copies.
+ */
+int GeometryParser::PlacePattern(const json& placement, G4LogicalVolume* logicalVolume,
+                                 const std::string& placementName, G4LogicalVolume* parentVolume,
+                                 int firstCopyNo) {
+    const json& pattern = placement["pattern"];
+    std::string type = pattern["type"].get<std::string>();
+
+    // Origin and orientation shared by all copies
+    G4ThreeVector origin;
+    G4RotationMatrix* baseRotation = nullptr;
+    ParsePlacement(placement, origin, baseRotation);
+
+    std::vector<G4ThreeVector> offsets;
+    std::vector<G4double> phis;
+    GeneratePatternOffsets(pattern, offsets, phis);
+
+    std::vector<G4ThreeVector> positions;
+    std::vector<G4RotationMatrix*> rotations;
+    for (size_t i = 0; i < offsets.size(); i++) {
+        positions.push_back(origin + offsets[i]);
+
+        // Rotating a copy by phi about the mother z axis multiplies the frame
+        // rotation by Rz(-phi) on the right
+        G4RotationMatrix* rotation = nullptr;
+        if (phis[i] != 0) {
+            G4RotationMatrix ringRotation;
+            ringRotation.rotateZ(-phis[i]);
+            rotation = new G4RotationMatrix(baseRotation ? (*baseRotation) * ringRotation : ringRotation);
+        } else if (baseRotation) {
+            rotation = new G4RotationMatrix(*baseRotation);
+        }
+        rotations.push_back(rotation);
+    }
+    delete baseRotation;
+
+    G4cout << "GeometryParser::PlacePattern() - Generated " << positions.size() << " copies of "
+           << placementName << " (" << type << " pattern)" << G4endl;
+
+    if (positions.empty()) {
+        return 0;
+    }
+
+    bool parameterised = pattern.contains("parameterised") && pattern["parameterised"].get<bool>();
+    if (!parameterised) {
+        for (size_t i = 0; i < positions.size(); i++) {
+            placementRotations.emplace_back(rotations[i]);
+            new G4PVPlacement(rotations[i], positions[i], logicalVolume,
+                              placementName + "_" + std::to_string(i), parentVolume,
+                              false, firstCopyNo + static_cast<int>(i));
+        }
+        return static_cast<int>(positions.size());
+    }
+
+    // Extent of all copies in the parent frame, from the corners of each copy's bounding box
+    G4ThreeVector solidMin, solidMax;
+    logicalVolume->GetSolid()->BoundingLimits(solidMin, solidMax);
+    G4ThreeVector lo(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector hi(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    G4double rMin = DBL_MAX;
+    G4double rMax = 0;
+    G4double halfDiagonal = 0.5 * (solidMax - solidMin).mag();
+    for (size_t i = 0; i < positions.size(); i++) {
+        G4RotationMatrix active = rotations[i] ? rotations[i]->inverse() : G4RotationMatrix();
+        for (int c = 0; c < 8; c++) {
+            G4ThreeVector corner((c & 1) ? solidMax.x() : solidMin.x(),
+                                 (c & 2) ? solidMax.y() : solidMin.y(),
+                                 (c & 4) ? solidMax.z() : solidMin.z());
+            G4ThreeVector p = active * corner + positions[i];
+            lo.set(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+            hi.set(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+            rMax = std::max(rMax, (p - origin).perp());
+        }
+        rMin = std::min(rMin, (positions[i] - origin).perp() - halfDiagonal);
+    }
+
+    std::string envelopeName = placementName + "_envelope";
+    G4VSolid* envelopeSolid = nullptr;
+    G4ThreeVector envelopeCentre;
+    if (type == "ring") {
+        envelopeCentre = G4ThreeVector(origin.x(), origin.y(), 0.5 * (lo.z() + hi.z()));
+        envelopeSolid = new G4Tubs(envelopeName, std::max(0., rMin), rMax,
+                                   0.5 * (hi.z() - lo.z()), 0, 2 * M_PI * rad);
+    } else {
+        envelopeCentre = 0.5 * (lo + hi);
+        envelopeSolid = new G4Box(envelopeName, 0.5 * (hi.x() - lo.x()),
+                                  0.5 * (hi.y() - lo.y()), 0.5 * (hi.z() - lo.z()));
+    }
+
+    G4LogicalVolume* envelopeLV = new G4LogicalVolume(envelopeSolid, parentVolume->GetMaterial(), envelopeName);
+    auto envelopeVis = new G4VisAttributes();
+    visAttributes.emplace_back(envelopeVis);
+    envelopeVis->SetVisibility(false);
+    envelopeLV->SetVisAttributes(envelopeVis);
+    new G4PVPlacement(nullptr, envelopeCentre, envelopeLV, envelopeName, parentVolume, false, firstCopyNo);
+
+    for (auto& position : positions) {
+        position -= envelopeCentre;
+    }
+    auto* parameterisation = new PlacementParameterisation(positions, rotations);
+    parameterisations.emplace_back(parameterisation);
+    new G4PVParameterised(placementName, logicalVolume, envelopeLV, kUndefined,
+                          parameterisation->GetNumberOfCopies(), parameterisation);
+
+    G4cout << "GeometryParser::PlacePattern() - Parameterised " << placementName
+           << " inside envelope " << envelopeName << " at " << envelopeCentre << G4endl;
+    return static_cast<int>(positions.size());
+}
+
 /**
  * @brief Create a G4VSolid from JSON configuration
  * @param config JSON configuration for the solid
@@ -1057,6 +1846,171 @@ json GeometryParser::LoadExternalGeometry(const std::string& filename) {
     return externalConfig;
 }
 
+/**
+ * @brief Create the regions listed under "regions" in the JSON config
+ * @details Each entry names a region, its root volumes ("volumes"), optional
+ *          production cuts in mm ("cuts": per particle gamma, e-, e+, proton, or
+ *          "all") and optional user limits ("user_limits": max_step [mm],
+ *          max_track_length [mm], max_time [ns], min_ekin [keV], min_range [mm]).
+ *          Daughters inherit the region of their mother unless they are a root of
+ *          another region.  Cuts not given keep the default region's cuts.  The
+ *          limits act through RegionStepLimiter, which is only attached when the
+ *          geometry at /run/initialize has limits.  The regions are created anew for
+ *          every construction (ClearGeometry() deletes them); a region of the same
+ *          name reuses its production cuts object, reset to the default cuts.
+ */
+void GeometryParser::SetupRegions() {
+    if (!geometryConfig.contains("regions")) return;
+
+    for (const auto& regionConfig : geometryConfig["regions"]) {
+        if (!regionConfig.contains("name")) {
+            G4cerr << "GeometryParser::SetupRegions() - Error: region without name" << G4endl;
+            continue;
+        }
+        std::string regionName = regionConfig["name"].get<std::string>();
+        if (G4RegionStore::GetInstance()->GetRegion(regionName, false)) {
+            G4cerr << "GeometryParser::SetupRegions() - Error: region " << regionName
+                   << " already exists" << G4endl;
+            continue;
+        }
+        G4Region* region = new G4Region(regionName);
+        regions.push_back(region);
+
+        if (regionConfig.contains("volumes")) {
+            for (const auto& volumeName : regionConfig["volumes"]) {
+                std::string name = volumeName.get<std::string>();
+                auto it = volumes.find(name);
+                if (it == volumes.end()) {
+                    G4cerr << "GeometryParser::SetupRegions() - Error: volume " << name
+                           << " of region " << regionName << " not found" << G4endl;
+                    continue;
+                }
+                region->AddRootLogicalVolume(it->second);
+            }
+        }
+
+        if (regionConfig.contains("cuts")) {
+            // Particles not listed keep the cuts of the default region (a bare
+            // G4ProductionCuts would give them 0 mm, i.e. the lowest threshold)
+            const G4ProductionCuts* defaultCuts =
+                G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+            G4ProductionCuts*& cuts = regionCuts[regionName];
+            if (!cuts) {
+                cuts = new G4ProductionCuts(*defaultCuts);
+            } else {
+                *cuts = *defaultCuts;
+            }
+            region->SetProductionCuts(cuts);
+            const auto& cutsConfig = regionConfig["cuts"];
+            if (cutsConfig.contains("all")) {
+                cuts->SetProductionCut(cutsConfig["all"].get<double>() * mm);
+            }
+            for (const char* particle : {"gamma", "e-", "e+", "proton"}) {
+                if (cutsConfig.contains(particle)) {
+                    cuts->SetProductionCut(cutsConfig[particle].get<double>() * mm, particle);
+                }
+            }
+        }
+
+        if (regionConfig.contains("user_limits")) {
+            const auto& limitsConfig = regionConfig["user_limits"];
+            auto limit = [&limitsConfig](const char* key, G4double unit, G4double fallback) {
+                return limitsConfig.contains(key) ? limitsConfig[key].get<double>() * unit : fallback;
+            };
+            G4UserLimits* limits = new G4UserLimits();
+            region->SetUserLimits(limits);
+            limits->SetMaxAllowedStep(limit("max_step", mm, DBL_MAX));
+            limits->SetUserMaxTrackLength(limit("max_track_length", mm, DBL_MAX));
+            limits->SetUserMaxTime(limit("max_time", ns, DBL_MAX));
+            limits->SetUserMinEkine(limit("min_ekin", keV, 0.));
+            limits->SetUserMinRange(limit("min_range", mm, 0.));
+            if (RegionStepLimiter::IsConstructed() && !RegionStepLimiter::IsActive()) {
+                G4cerr << "GeometryParser::SetupRegions() - Warning: user limits of region " << regionName
+                       << " are ignored: the geometry at /run/initialize had none, so no step limiter"
+                       << " is attached" << G4endl;
+            }
+        }
+
+        G4cout << "GeometryParser::SetupRegions() - Region " << regionName << ": "
+               << region->GetNumberOfRootVolumes() << " root volume(s)"
+               << (region->GetProductionCuts() ? ", production cuts" : "")
+               << (region->GetUserLimits() ? ", user limits" : "") << G4endl;
+    }
+}
+
+/**
+ * @brief Register the volumes flagged with "record_surface" in the JSON config
+ * @details The flag is either a boolean or an object {"kill": bool}; with kill the
+ *          particles are stopped once recorded, so the inside is not simulated
+ */
+void GeometryParser::SetupRecordSurfaces() {
+    PhaseSpaceWriter::ClearSurfaces();
+    if (!geometryConfig.contains("volumes")) return;
+
+    for (const auto& volumeConfig : geometryConfig["volumes"]) {
+        if (!volumeConfig.contains("record_surface")) continue;
+        const auto& surface = volumeConfig["record_surface"];
+        G4bool kill = false;
+        if (surface.is_boolean()) {
+            if (!surface.get<bool>()) continue;
+        } else if (surface.is_object()) {
+            kill = surface.value("kill", false);
+        } else {
+            throw std::runtime_error("record_surface must be a boolean or an object");
+        }
+
+        std::string name = volumeConfig["name"].get<std::string>();
+        auto it = volumes.find(name);
+        if (it == volumes.end()) {
+            G4cerr << "GeometryParser::SetupRecordSurfaces() - Error: volume " << name
+                   << " not found" << G4endl;
+            continue;
+        }
+        PhaseSpaceWriter::AddSurface(it->second, kill);
+        G4cout << "GeometryParser::SetupRecordSurfaces() - Recording particles entering " << name
+               << (kill ? " (killed after recording)" : "") << G4endl;
+    }
+}
+
+/**
+ * @brief Register the per-volume "importance" values for importance biasing
+ * @details The biased particles come from the top-level "importance_particles"
+ *          array (default neutron and gamma); volumes without importance get 1
+ */
+void GeometryParser::SetupImportances() {
+    ImportanceBiasing::Clear();
+
+    auto setImportance = [this](const json& volumeConfig) {
+        if (!volumeConfig.contains("importance")) return;
+        std::string name = volumeConfig["name"].get<std::string>();
+        G4double importance = volumeConfig["importance"].get<double>();
+        if (importance < 0) {
+            throw std::runtime_error("Negative importance for volume " + name);
+        }
+        auto it = volumes.find(name);
+        if (it == volumes.end()) {
+            G4cerr << "GeometryParser::SetupImportances() - Error: volume " << name
+                   << " not found" << G4endl;
+            return;
+        }
+        ImportanceBiasing::SetImportance(it->second, importance);
+        G4cout << "GeometryParser::SetupImportances() - " << name << ": importance " << importance << G4endl;
+    };
+
+    setImportance(geometryConfig["world"]);
+    if (geometryConfig.contains("volumes")) {
+        for (const auto& volumeConfig : geometryConfig["volumes"]) {
+            setImportance(volumeConfig);
+        }
+    }
+
+    if (ImportanceBiasing::HasImportances() && geometryConfig.contains("importance_particles")) {
+        for (const auto& particle : geometryConfig["importance_particles"]) {
+            ImportanceBiasing::AddParticle(particle.get<std::string>());
+        }
+    }
+}
+
 /**
  * @brief Import an assembled geometry from an external JSON file
  * @param config JSON configuration for the import
@@ -1067,29 +2021,67 @@ json GeometryParser::LoadExternalGeometry(const std::string& filename) {
  */
 /**
  * @brief Setup sensitive detectors for active volumes
- * @details This method assigns sensitive detectors to volumes marked as active in the JSON config
+ * @details This method assigns sensitive detectors to volumes marked as active in the JSON config.
+ *          "hitsCollectionName" is either the collection name (a tracker) or an object
+ *          {"name": ..., "type": ...} selecting a type of the SensitiveDetectorFactory.
+ * @throws std::runtime_error for an unknown type, or a collection used with two types
  */
 void GeometryParser::SetupSensitiveDetectors() {
     // Get the SD manager
     G4SDManager* sdManager = G4SDManager::GetSDMpointer();
     
     // Map to track already-created sensitive detectors by their hits collection name
-    std::map<std::string, MySensitiveDetector*> sdMap;
+    std::map<std::string, G4VSensitiveDetector*> sdMap;
+    std::map<std::string, std::string> sdTypes;
     
     // Helper lambda to assign a sensitive detector to a single volume config entry
     auto processVolConfig = [&](const json& volConfig) {
         if (!volConfig.contains("hitsCollectionName")) return;
-        std::string hitsCollName = volConfig["hitsCollectionName"].get<std::string>();
+        const json& hitsColl = volConfig["hitsCollectionName"];
+        std::string hitsCollName;
+        std::string sdType = SensitiveDetectorFactory::DefaultType;
+        if (hitsColl.is_object()) {
+            hitsCollName = hitsColl.at("name").get<std::string>();
+            sdType = hitsColl.value("type", sdType);
+        } else {
+            hitsCollName = hitsColl.get<std::string>();
+        }
+
+        if (!SensitiveDetectorFactory::IsKnown(sdType)) {
+            std::string known;
+            for (const auto& type : SensitiveDetectorFactory::Types()) known += " " + type;
+            throw std::runtime_error("Unknown sensitive detector type \"" + sdType + "\" for collection "
+                                     + hitsCollName + " (known:" + known + ")");
+        }
+        auto typeIt = sdTypes.find(hitsCollName);
+        if (typeIt != sdTypes.end() && typeIt->second != sdType) {
+            throw std::runtime_error("Hits collection " + hitsCollName + " is used with types "
+                                     + typeIt->second + " and " + sdType);
+        }
 
         // Create a new SD for this collection name if we haven't already
+        // After a geometry rebuild the detector is already registered; reuse it
+        // and deactivate the ones of other types, which cannot be removed
         if (sdMap.find(hitsCollName) == sdMap.end()) {
-            G4String sdName = hitsCollName + "_SD";
-            MySensitiveDetector* sd = new MySensitiveDetector(sdName, hitsCollName);
+            for (const auto& type : SensitiveDetectorFactory::Types()) {
+                G4String name = SensitiveDetectorFactory::DetectorName(hitsCollName, type);
+                G4VSensitiveDetector* existing = sdManager->FindSensitiveDetector(name, false);
+                if (!existing) continue;
+                if (type == sdType) {
+                    sdMap[hitsCollName] = existing;
+                }
+                sdManager->Activate(name, type == sdType);
+            }
+        }
+        if (sdMap.find(hitsCollName) == sdMap.end()) {
+            G4String sdName = SensitiveDetectorFactory::DetectorName(hitsCollName, sdType);
+            G4VSensitiveDetector* sd = SensitiveDetectorFactory::Create(sdType, sdName, hitsCollName);
             sdManager->AddNewDetector(sd);
             sdMap[hitsCollName] = sd;
-            G4cout << "Created sensitive detector \"" << sdName
+            G4cout << "Created " << sdType << " sensitive detector \"" << sdName
                    << "\" with hits collection \"" << hitsCollName << "\"" << G4endl;
         }
+        sdTypes[hitsCollName] = sdType;
 
         // Get the logical volume (try logicalVolumeMap first, fall back to volumes)
         std::string volName = volConfig["name"].get<std::string>();
@@ -1110,17 +2102,28 @@ void GeometryParser::SetupSensitiveDetectors() {
         }
     };
 
+    std::function<void(const json&)> processAssembly = [&](const json& volConfig) {
+        if (!volConfig.contains("type") || volConfig["type"].get<std::string>() != "assembly"
+            || !volConfig.contains("components")) return;
+        for (const auto& compConfig : volConfig["components"]) {
+            processVolConfig(compConfig);
+            processAssembly(compConfig);
+        }
+    };
+
     // Iterate through all volumes in the JSON configuration
     for (const auto& volConfig : geometryConfig["volumes"]) {
         // Process the volume itself
         processVolConfig(volConfig);
 
-        // Also process components inside assembly volumes
-        if (volConfig.contains("type") && volConfig["type"].get<std::string>() == "assembly"
-            && volConfig.contains("components")) {
-            for (const auto& compConfig : volConfig["components"]) {
-                processVolConfig(compConfig);
-            }
+        // Also process components inside (possibly nested) assembly volumes
+        processAssembly(volConfig);
+    }
+
+    // Volumes of imported geometries (shared by all instances)
+    for (const auto& [prefix, prototype] : importPrototypes) {
+        for (const auto& volConfig : prototype.volumeConfigs) {
+            processVolConfig(volConfig);
         }
     }
 }
@@ -1150,11 +2153,15 @@ void GeometryParser::CreateAssembly(const json& config) {
         std::string childName = compConfig["name"].get<std::string>();
         G4cout << "Processing component " << childName << " of assembly " << assemblyName << G4endl;
 
-        // Skip if this is another assembly (to avoid circular references)
+        // Nested assemblies are imprinted together with their parent
         if (compConfig["type"].get<std::string>() == "assembly") {
-            G4cout << "Warning: Assembly " << childName
-                   << " is a component of assembly " << assemblyName
-                   << ". Nested assemblies are not supported." << G4endl;
+            CreateAssembly(compConfig);
+            if (!compConfig.contains("placements")) continue;
+            for (const auto& placement : compConfig["placements"]) {
+                G4Transform3D transform = ParseAssemblyTransform(placement);
+                G4cout << "Adding nested assembly " << childName << " to assembly " << assemblyName << G4endl;
+                assembly->AddPlacedAssembly(assemblies[childName], transform);
+            }
             continue;
         }
 
@@ -1178,6 +2185,7 @@ void GeometryParser::CreateAssembly(const json& config) {
             ParsePlacement(placement, position, rotation);
             G4cout << "Adding " << childName << " to assembly " << assemblyName << " at position " << position << G4endl;
             assembly->AddPlacedVolume(childLV, position, rotation);
+            delete rotation;  // AddPlacedVolume keeps its own copy
         }
     }
 
@@ -1185,85 +2193,375 @@ void GeometryParser::CreateAssembly(const json& config) {
     G4cout << "Created assembly " << assemblyName << G4endl;
 }
 
+/**
+ * @brief Parse the transformation of an assembly placement
+ * @param placement JSON object with x, y, z and optional rotation
+ * @return Active transformation as used by G4AssemblyVolume::MakeImprint
+ */
+G4Transform3D GeometryParser::ParseAssemblyTransform(const json& placement) {
+    G4ThreeVector position;
+    if (placement.contains("x") && placement.contains("y") && placement.contains("z")) {
+        position = G4ThreeVector(placement["x"].get<double>()*mm,
+                                 placement["y"].get<double>()*mm,
+                                 placement["z"].get<double>()*mm);
+    }
+    G4RotationMatrix rotation;
+    if (placement.contains("rotation")) {
+        G4RotationMatrix* parsed = ParseRotation(placement["rotation"], true);
+        rotation = *parsed;
+        delete parsed;
+    }
+    return G4Transform3D(rotation, position);
+}
 
 /**
- * @brief Import an assembled geometry from an external JSON file
- * @param config JSON configuration for the import
- * @param parentVolume Parent logical volume to place the imported geometry in
- * @details Imports a geometry defined in an external JSON file and places it
- *          in the parent volume with the specified transformation.
+ * @brief Build (or reuse) the envelope mother volume of an assembly
+ * @param config JSON configuration for the assembly
+ * @param material Material filling the envelope
+ * @param shape Envelope shape used if the assembly does not set "envelope" itself
+ * @return Envelope logical volume and its centre in the assembly frame
+ * @throws std::runtime_error if the shape is unknown or the assembly has no components
+ * @details The components are placed with exactly the transformations a G4AssemblyVolume
+ *          imprint would give them, but relative to the envelope centre.  The envelope is
+ *          the bounding box of all component bounding boxes ("box"), or a cylinder along
+ *          the assembly z axis enclosing them ("cylinder").  Nested assemblies become
+ *          envelopes inside the envelope.  One envelope is built per fill material and
+ *          shared by all placements.
+ */
+const GeometryParser::AssemblyEnvelope& GeometryParser::BuildAssemblyEnvelope(const json& config,
+                                                                               G4Material* material,
+                                                                               const std::string& shape) {
+    std::string assemblyName = config["name"].get<std::string>();
+    auto key = std::make_pair(assemblyName, material);
+    auto cached = assemblyEnvelopes.find(key);
+    if (cached != assemblyEnvelopes.end()) {
+        return cached->second;
+    }
+
+    std::string envelopeShape = config.contains("envelope") ? config["envelope"].get<std::string>() : shape;
+    if (envelopeShape != "box" && envelopeShape != "cylinder") {
+        throw std::runtime_error("Unknown envelope shape for assembly " + assemblyName + ": " + envelopeShape);
+    }
+
+    // Collect every daughter with its transformation in the assembly frame
+    struct Daughter {
+        G4LogicalVolume* logical;
+        G4Transform3D transform;
+        std::string name;
+    };
+    std::vector<Daughter> daughters;
+    if (config.contains("components")) {
+        for (const auto& compConfig : config["components"]) {
+            if (!compConfig.contains("placements")) continue;
+            std::string childName = compConfig["name"].get<std::string>();
+
+            if (compConfig["type"].get<std::string>() == "assembly") {
+                const AssemblyEnvelope& nested = BuildAssemblyEnvelope(compConfig, material, envelopeShape);
+                for (const auto& placement : compConfig["placements"]) {
+                    G4Transform3D transform = ParseAssemblyTransform(placement);
+                    std::string placementName = placement.contains("name") ?
+                                                placement["name"].get<std::string>() : childName;
+                    daughters.push_back({nested.logical,
+                                         G4Transform3D(transform.getRotation(),
+                                                       transform.getTranslation() + transform.getRotation() * nested.centre),
+                                         placementName});
+                }
+                continue;
+            }
+
+            G4LogicalVolume* childLV = (volumes.find(childName) == volumes.end()) ?
+                                       CreateVolume(compConfig) : volumes[childName];
+            for (const auto& placement : compConfig["placements"]) {
+                // Same convention as G4AssemblyVolume::AddPlacedVolume: the rotation is active
+                G4ThreeVector position;
+                G4RotationMatrix* rotation = nullptr;
+                ParsePlacement(placement, position, rotation);
+                G4RotationMatrix active = rotation ? *rotation : G4RotationMatrix();
+                delete rotation;
+                std::string placementName = placement.contains("name") ?
+                                            placement["name"].get<std::string>() : childName;
+                daughters.push_back({childLV, G4Transform3D(active, position), placementName});
+            }
+        }
+    }
+    if (daughters.empty()) {
+        throw std::runtime_error("Assembly " + assemblyName + " has no placed components");
+    }
+
+    // Extent of all daughters from the corners of their bounding boxes
+    std::vector<G4ThreeVector> corners;
+    G4ThreeVector lo(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector hi(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    for (const auto& daughter : daughters) {
+        G4ThreeVector solidMin, solidMax;
+        daughter.logical->GetSolid()->BoundingLimits(solidMin, solidMax);
+        for (int c = 0; c < 8; c++) {
+            G4ThreeVector corner((c & 1) ? solidMax.x() : solidMin.x(),
+                                 (c & 2) ? solidMax.y() : solidMin.y(),
+                                 (c & 4) ? solidMax.z() : solidMin.z());
+            G4ThreeVector p = daughter.transform.getRotation() * corner + daughter.transform.getTranslation();
+            lo.set(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+            hi.set(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+            corners.push_back(p);
+        }
+    }
+
+    // Envelopes of the same assembly in other mother materials get the material appended
+    std::string envelopeName = assemblyName + "_envelope";
+    for (const auto& entry : assemblyEnvelopes) {
+        if (entry.first.first == assemblyName) {
+            envelopeName += "_" + material->GetName();
+            break;
+        }
+    }
+
+    AssemblyEnvelope envelope;
+    envelope.centre = 0.5 * (lo + hi);
+    G4VSolid* envelopeSolid = nullptr;
+    if (envelopeShape == "cylinder") {
+        G4double rMax = 0;
+        for (const auto& p : corners) {
+            rMax = std::max(rMax, (p - envelope.centre).perp());
+        }
+        envelopeSolid = new G4Tubs(envelopeName, 0, rMax, 0.5 * (hi.z() - lo.z()), 0, 2 * M_PI * rad);
+    } else {
+        envelopeSolid = new G4Box(envelopeName, 0.5 * (hi.x() - lo.x()),
+                                  0.5 * (hi.y() - lo.y()), 0.5 * (hi.z() - lo.z()));
+    }
+
+    envelope.logical = new G4LogicalVolume(envelopeSolid, material, envelopeName);
+    auto envelopeVis = new G4VisAttributes();
+    visAttributes.emplace_back(envelopeVis);
+    envelopeVis->SetVisibility(false);
+    envelope.logical->SetVisAttributes(envelopeVis);
+    if (config.contains("smartless")) {
+        envelope.logical->SetSmartless(config["smartless"].get<double>());
+    }
+
+    std::map<G4LogicalVolume*, int> copyCounter;
+    for (const auto& daughter : daughters) {
+        G4Transform3D local(daughter.transform.getRotation(),
+                            daughter.transform.getTranslation() - envelope.centre);
+        new G4PVPlacement(local, daughter.logical, daughter.name, envelope.logical,
+                          false, copyCounter[daughter.logical]++);
+    }
+
+    G4cout << "GeometryParser::BuildAssemblyEnvelope() - Built " << envelopeShape << " envelope "
+           << envelopeName << " with " << daughters.size() << " daughters, centre " << envelope.centre << G4endl;
+    return assemblyEnvelopes.emplace(key, envelope).first->second;
+}
+
+
+/**
+ * @brief Build the volumes of an external geometry file once
+ * @param config JSON configuration of the importing volume
+ * @return Prototype whose envelope can be placed any number of times
+ * @throws std::runtime_error if the file cannot be loaded or the prefix is already used by another file
+ * @details All volumes of the external file are created with their names prefixed by
+ *          "name_prefix" (default: the file stem).  The envelope is the volume flagged
+ *          "root", otherwise the external file's world.  Daughters are placed inside the
+ *          envelope through their "placements" (or the legacy "mother_volume" key); a parent
+ *          equal to the external world's name refers to the envelope.  Materials of the
+ *          external file are only used if the main configuration does not define them.
  */
-void GeometryParser::ImportAssembledGeometry(const json& config, G4LogicalVolume* parentVolume) {
-    // Load the external file
+const GeometryParser::ImportPrototype& GeometryParser::BuildImportPrototype(const json& config) {
     std::string filename = config["external_file"].get<std::string>();
+    std::string resolvedPath = (fs::path(configPath) / filename).lexically_normal().string();
+    std::string prefix = config.contains("name_prefix") ?
+                         config["name_prefix"].get<std::string>() :
+                         fs::path(filename).stem().string();
+
+    auto cached = importPrototypes.find(prefix);
+    if (cached != importPrototypes.end()) {
+        if (cached->second.path != resolvedPath) {
+            throw std::runtime_error("Import prefix " + prefix + " is used by both " + cached->second.path +
+                                     " and " + resolvedPath + "; set a distinct name_prefix");
+        }
+        return cached->second;
+    }
+
+    G4cout << "GeometryParser::BuildImportPrototype() - Building " << resolvedPath
+           << " with prefix " << prefix << G4endl;
     json externalConfig = LoadExternalGeometry(filename);
-    
-    // Get transformation for the assembly using the new ParsePlacement function
-    // which handles both the new placement format and legacy format
-    G4ThreeVector position;
-    G4RotationMatrix* rotation = nullptr;
-    ParsePlacement(config, position, rotation);
-    
-    // Create volumes from the external file
-    std::map<std::string, G4LogicalVolume*> externalVolumes;
-    
-    // First, create all logical volumes
-    for (const auto& volConfig : externalConfig["volumes"]) {
-        std::string name = volConfig["name"].get<std::string>();
-        
-        // If a name prefix is specified, add it to avoid name collisions
-        if (config.contains("name_prefix")) {
-            name = config["name_prefix"].get<std::string>() + "_" + name;
+
+    if (externalConfig.contains("materials")) {
+        for (auto it = externalConfig["materials"].begin(); it != externalConfig["materials"].end(); ++it) {
+            if (!importedMaterials.contains(it.key())) {
+                importedMaterials[it.key()] = it.value();
+            }
         }
-        
-        // Create the volume and store in both the class-level and local maps
-        G4LogicalVolume* logicalVolume = CreateVolume(volConfig);
-        volumes[volConfig["name"].get<std::string>()] = logicalVolume;
-        externalVolumes[name] = logicalVolume;
-        
-        // Store in logical volume map with _logical suffix for sensitive detector setup
-        logicalVolumeMap[volConfig["name"].get<std::string>() + "_logical"] = logicalVolume;
     }
-    
-    // Then, place all volumes
-    for (const auto& volConfig : externalConfig["volumes"]) {
-        std::string name = volConfig["name"].get<std::string>();
-        
-        // If a name prefix is specified, add it to avoid name collisions
-        if (config.contains("name_prefix")) {
-            name = config["name_prefix"].get<std::string>() + "_" + name;
+
+    // Pick the envelope: the volume flagged "root", otherwise the external world
+    std::vector<json> externalVolumes;
+    if (externalConfig.contains("volumes")) {
+        for (const auto& volConfig : externalConfig["volumes"]) {
+            externalVolumes.push_back(volConfig);
         }
-        
-        // Skip the root volume, which will be placed in the parent volume
+    }
+    std::string worldName;
+    if (externalConfig.contains("world")) {
+        worldName = externalConfig["world"]["name"].get<std::string>();
+    }
+    std::string rootName;
+    for (const auto& volConfig : externalVolumes) {
         if (volConfig.contains("root") && volConfig["root"].get<bool>()) {
-            G4LogicalVolume* rootVolume = externalVolumes[name];
-            
-            // Place the root volume in the parent volume
-            new G4PVPlacement(rotation, position, rootVolume, name, parentVolume, false, 0);
+            rootName = volConfig["name"].get<std::string>();
+            break;
+        }
+    }
+    if (rootName.empty()) {
+        if (worldName.empty()) {
+            throw std::runtime_error("External geometry " + resolvedPath + " has neither a root volume nor a world");
+        }
+        rootName = worldName;
+        externalVolumes.insert(externalVolumes.begin(), externalConfig["world"]);
+    }
+
+    auto prefixed = [&](const std::string& name) {
+        return prefix + "_" + ((name == worldName) ? rootName : name);
+    };
+
+    ImportPrototype prototype;
+    prototype.path = resolvedPath;
+
+    // First create all logical volumes under their prefixed names
+    for (auto volConfig : externalVolumes) {
+        std::string type = volConfig.contains("type") ? volConfig["type"].get<std::string>() : "";
+        if (type == "assembly" || volConfig.contains("external_file")) {
+            G4cout << "GeometryParser::BuildImportPrototype() - Warning: skipping "
+                   << volConfig["name"].get<std::string>()
+                   << "; assemblies and nested imports are not supported in imported files" << G4endl;
             continue;
         }
-        
-        // Place the volume in its mother volume
+        std::string originalName = volConfig["name"].get<std::string>();
+        bool isRoot = (originalName == rootName);
+        volConfig["name"] = prefixed(originalName);
+        volConfig["g4name"] = volConfig["name"];
+        if (volConfig.contains("placements")) {
+            for (auto& placement : volConfig["placements"]) {
+                if (placement.contains("parent")) {
+                    placement["parent"] = prefixed(placement["parent"].get<std::string>());
+                }
+                if (placement.contains("name")) {
+                    placement["name"] = prefix + "_" + placement["name"].get<std::string>();
+                }
+            }
+        }
         if (volConfig.contains("mother_volume")) {
-            std::string motherName = volConfig["mother_volume"].get<std::string>();
-            
-            // If a name prefix is specified, add it to the mother name too
-            if (config.contains("name_prefix")) {
-                motherName = config["name_prefix"].get<std::string>() + "_" + motherName;
+            volConfig["mother_volume"] = prefixed(volConfig["mother_volume"].get<std::string>());
+        }
+
+        G4LogicalVolume* logicalVolume = CreateVolume(volConfig);
+        if (isRoot) {
+            prototype.envelope = logicalVolume;
+        }
+        prototype.volumeConfigs.push_back(volConfig);
+    }
+
+    if (!prototype.envelope) {
+        throw std::runtime_error("Could not create the root volume of " + resolvedPath);
+    }
+
+    // Then place the daughters inside the envelope
+    std::map<std::pair<std::string, std::string>, int> copyCounter;
+    for (const auto& volConfig : prototype.volumeConfigs) {
+        std::string name = volConfig["name"].get<std::string>();
+        if (volumes[name] == prototype.envelope) continue;
+        G4LogicalVolume* logicalVolume = volumes[name];
+
+        std::vector<json> placements;
+        if (volConfig.contains("placements")) {
+            for (const auto& placement : volConfig["placements"]) {
+                placements.push_back(placement);
             }
-            
-            G4LogicalVolume* motherVolume = externalVolumes[motherName];
-            G4LogicalVolume* logicalVolume = externalVolumes[name];
-            
-            // Parse position and rotation using the new ParsePlacement function
-            G4ThreeVector volPosition;
-            G4RotationMatrix* volRotation = nullptr;
-            ParsePlacement(volConfig, volPosition, volRotation);
-            
-            new G4PVPlacement(volRotation, volPosition, logicalVolume, name, motherVolume, false, 0);
+        } else if (volConfig.contains("mother_volume")) {
+            // Legacy format: the transformation lives on the volume itself
+            json placement = volConfig;
+            placement["parent"] = volConfig["mother_volume"];
+            placements.push_back(placement);
         }
+
+        for (const auto& placement : placements) {
+            std::string parentName = placement.contains("parent") ?
+                                     placement["parent"].get<std::string>() :
+                                     prefix + "_" + rootName;
+            if (volumes.find(parentName) == volumes.end()) {
+                G4cerr << "GeometryParser::BuildImportPrototype() - Error: Parent volume " << parentName
+                       << " not found for " << name << G4endl;
+                continue;
+            }
+            G4LogicalVolume* parentVolume = volumes[parentName];
+            std::string placementName = placement.contains("name") ?
+                                        placement["name"].get<std::string>() : name;
+            auto key = std::make_pair(name, parentName);
+
+            if (placement.contains("pattern")) {
+                copyCounter[key] += PlacePattern(placement, logicalVolume, placementName,
+                                                 parentVolume, copyCounter[key]);
+                continue;
+            }
+
+            G4ThreeVector position;
+            G4RotationMatrix* rotation = nullptr;
+            ParsePlacement(placement, position, rotation);
+            placementRotations.emplace_back(rotation);
+            new G4PVPlacement(rotation, position, logicalVolume, placementName, parentVolume,
+                              false, copyCounter[key]++);
+        }
+    }
+
+    G4cout << "GeometryParser::BuildImportPrototype() - Built " << prototype.volumeConfigs.size()
+           << " volumes from " << resolvedPath << G4endl;
+    return importPrototypes.emplace(prefix, std::move(prototype)).first->second;
+}
+
+/**
+ * @brief Place an imported geometry at every placement of the importing volume
+ * @param config JSON configuration for the import
+ * @throws std::runtime_error if the external geometry cannot be built
+ * @details The external file is built once (see BuildImportPrototype()); every placement
+ *          then adds one physical volume of the shared envelope, with its own copy number.
+ *          Placement patterns are supported as for regular volumes.
+ */
+void GeometryParser::ImportAssembledGeometry(const json& config) {
+    const ImportPrototype& prototype = BuildImportPrototype(config);
+    std::string name = config["name"].get<std::string>();
+
+    if (!config.contains("placements") || config["placements"].empty()) {
+        G4cout << "GeometryParser::ImportAssembledGeometry() - Warning: No placements for import " << name << G4endl;
+        return;
+    }
+
+    std::map<std::string, int> copyCounter;
+    for (const auto& placement : config["placements"]) {
+        std::string parentName = placement.contains("parent") ?
+                                 placement["parent"].get<std::string>() : "World";
+        if (volumes.find(parentName) == volumes.end()) {
+            G4cerr << "Error: Parent volume " << parentName << " not found for import " << name << G4endl;
+            continue;
+        }
+        G4LogicalVolume* parentVolume = volumes[parentName];
+        std::string placementName = placement.contains("name") ?
+                                    placement["name"].get<std::string>() : name;
+
+        if (placement.contains("pattern")) {
+            copyCounter[parentName] += PlacePattern(placement, prototype.envelope, placementName,
+                                                    parentVolume, copyCounter[parentName]);
+            continue;
+        }
+
+        G4ThreeVector position;
+        G4RotationMatrix* rotation = nullptr;
+        ParsePlacement(placement, position, rotation);
+        G4cout << "GeometryParser::ImportAssembledGeometry() - Placing " << placementName << " in "
+               << parentName << " at position " << position << G4endl;
+        placementRotations.emplace_back(rotation);
+        new G4PVPlacement(rotation, position, prototype.envelope, placementName, parentVolume,
+                          false, copyCounter[parentName]++);
     }
 }
+
 // Box solid creation function
 G4VSolid* GeometryParser::CreateBoxSolid(const json& dims, const std::string& name) {
     // All dimensions are in mm, but we need to divide by 2 for half-dimensions
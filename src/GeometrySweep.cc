@@ -0,0 +1,283 @@
+/**
+ * @file GeometrySweep.cc
+ * @brief Implementation of the GeometrySweep class
+ */
+
+#include "GeometrySweep.hh"
+#include "DetectorConstruction.hh"
+#include "GeometryParser.hh"
+#include "RunAction.hh"
+#include "PhaseSpaceWriter.hh"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UImessenger.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Nested messenger class for GeometrySweep
+ *
+ * Handles the /detector/sweep/ commands
+ */
+class GeometrySweep::SweepMessenger : public G4UImessenger
+{
+  public:
+    SweepMessenger(GeometrySweep* sweep);
+    virtual ~SweepMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    GeometrySweep* fSweep;
+
+    G4UIdirectory*        fSweepDir;
+    G4UIcmdWithAString*   fAddGeometryCmd;
+    G4UIcmdWithAString*   fAddPatchCmd;
+    G4UIcommand*          fListCmd;
+    G4UIcommand*          fClearCmd;
+    G4UIcmdWithAnInteger* fRunCmd;
+};
+
+/**
+ * @brief Constructor for the SweepMessenger
+ * @param sweep Pointer to the associated GeometrySweep
+ */
+GeometrySweep::SweepMessenger::SweepMessenger(GeometrySweep* sweep)
+: fSweep(sweep)
+{
+    fSweepDir = new G4UIdirectory("/detector/sweep/");
+    fSweepDir->SetGuidance("Run several geometry variants with one physics initialisation");
+
+    fAddGeometryCmd = new G4UIcmdWithAString("/detector/sweep/addGeometry", this);
+    fAddGeometryCmd->SetGuidance("Add a variant given by a complete geometry JSON file");
+    fAddGeometryCmd->SetParameterName("GeometryFile", false);
+
+    fAddPatchCmd = new G4UIcmdWithAString("/detector/sweep/addPatch", this);
+    fAddPatchCmd->SetGuidance("Add a variant given by a JSON patch of the current geometry file");
+    fAddPatchCmd->SetGuidance("The file holds an RFC 6902 patch array or an RFC 7386 merge-patch object");
+    fAddPatchCmd->SetParameterName("PatchFile", false);
+
+    fListCmd = new G4UIcommand("/detector/sweep/list", this);
+    fListCmd->SetGuidance("Print the list of variants");
+
+    fClearCmd = new G4UIcommand("/detector/sweep/clear", this);
+    fClearCmd->SetGuidance("Remove all variants");
+
+    fRunCmd = new G4UIcmdWithAnInteger("/detector/sweep/run", this);
+    fRunCmd->SetGuidance("Run N events for every variant, each into <output>_<variant>.root");
+    fRunCmd->SetParameterName("nEvents", false);
+    fRunCmd->SetRange("nEvents>=0");
+    fRunCmd->AvailableForStates(G4State_Idle);
+}
+
+/**
+ * @brief Destructor for the SweepMessenger
+ */
+GeometrySweep::SweepMessenger::~SweepMessenger()
+{
+    delete fAddGeometryCmd;
+    delete fAddPatchCmd;
+    delete fListCmd;
+    delete fClearCmd;
+    delete fRunCmd;
+    delete fSweepDir;
+}
+
+/**
+ * @brief Handle UI commands
+ * @param command The command being executed
+ * @param newValue The new value for the command parameter
+ */
+void GeometrySweep::SweepMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fAddGeometryCmd) {
+        fSweep->AddGeometry(newValue);
+    } else if (command == fAddPatchCmd) {
+        fSweep->AddPatch(newValue);
+    } else if (command == fListCmd) {
+        fSweep->List();
+    } else if (command == fClearCmd) {
+        fSweep->Clear();
+    } else if (command == fRunCmd) {
+        fSweep->Run(fRunCmd->GetNewIntValue(newValue));
+    }
+}
+
+/**
+ * @brief Constructor implementation
+ * @param detector Detector construction whose geometry is varied
+ */
+GeometrySweep::GeometrySweep(DetectorConstruction* detector)
+: fMessenger(nullptr),
+  fDetector(detector)
+{
+    fMessenger = new SweepMessenger(this);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+GeometrySweep::~GeometrySweep()
+{
+    delete fMessenger;
+}
+
+/**
+ * @brief Variant label from the file stem, made unique within the sweep
+ * @param filename Geometry or patch file of the variant
+ * @return Label for the new variant
+ */
+std::string GeometrySweep::UniqueLabel(const std::string& filename) const
+{
+    std::string label = fs::path(filename).stem().string();
+    for (const auto& variant : fVariants) {
+        if (variant.label == label) {
+            return label + "_" + std::to_string(fVariants.size());
+        }
+    }
+    return label;
+}
+
+/**
+ * @brief Add a variant given by a complete geometry file
+ * @param filename Path to the geometry JSON file
+ */
+void GeometrySweep::AddGeometry(const std::string& filename)
+{
+    fVariants.push_back({UniqueLabel(filename), filename, json()});
+    G4cout << "GeometrySweep::AddGeometry() - Variant " << fVariants.back().label
+           << ": " << filename << G4endl;
+}
+
+/**
+ * @brief Add a variant given by a patch of the current geometry file
+ * @param filename Path to a JSON file holding a patch array or merge-patch object
+ * @details The patch is read now but applied to the geometry file that is current
+ *          when the sweep runs
+ */
+void GeometrySweep::AddPatch(const std::string& filename)
+{
+    json patch;
+    try {
+        patch = GeometryParser::ReadJsonFile(filename);
+    } catch (const std::exception& e) {
+        G4cerr << "GeometrySweep::AddPatch() - Error: " << e.what() << G4endl;
+        return;
+    }
+    if (!patch.is_array() && !patch.is_object()) {
+        G4cerr << "GeometrySweep::AddPatch() - Error: " << filename
+               << " holds neither a patch array nor a merge-patch object" << G4endl;
+        return;
+    }
+
+    fVariants.push_back({UniqueLabel(filename), filename, patch});
+    G4cout << "GeometrySweep::AddPatch() - Variant " << fVariants.back().label
+           << ": " << filename << (patch.is_array() ? " (JSON patch)" : " (merge patch)") << G4endl;
+}
+
+/**
+ * @brief Print the list of variants
+ */
+void GeometrySweep::List() const
+{
+    G4cout << "GeometrySweep - " << fVariants.size() << " variant(s):" << G4endl;
+    for (size_t i = 0; i < fVariants.size(); i++) {
+        G4cout << "  " << i << "  " << fVariants[i].label << "  " << fVariants[i].file
+               << (fVariants[i].patch.is_null() ? "" : " (patch)") << G4endl;
+    }
+}
+
+/**
+ * @brief Run every variant
+ * @param nEvents Number of events per variant
+ * @details For each variant the geometry is rebuilt through DetectorConstruction
+ *          (in place if only positions, dimensions or materials changed), the output
+ *          file is set to <output>_<variant>.root and N events are run.  Physics is
+ *          not re-initialised between variants.  Afterwards the original geometry
+ *          file and output name are restored.
+ */
+void GeometrySweep::Run(G4int nEvents)
+{
+    if (fVariants.empty()) {
+        G4cout << "GeometrySweep::Run() - No variants defined" << G4endl;
+        return;
+    }
+
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+    auto* runAction = static_cast<const RunAction*>(runManager->GetUserRunAction());
+    if (!runAction) {
+        G4cerr << "GeometrySweep::Run() - Error: no RunAction, call /run/initialize first" << G4endl;
+        return;
+    }
+
+    std::string baseGeometry = fDetector->GetGeometryFile();
+    std::string baseOutput = runAction->GetOutputFileName();
+    fs::path outputPath(baseOutput);
+    const G4String basePhaseSpace = PhaseSpaceWriter::GetFileName();
+    G4UImanager* uiManager = G4UImanager::GetUIpointer();
+
+    json baseConfig;
+    for (const auto& variant : fVariants) {
+        if (variant.patch.is_null()) continue;
+        try {
+            baseConfig = GeometryParser::ReadJsonFile(baseGeometry);
+        } catch (const std::exception& e) {
+            G4cerr << "GeometrySweep::Run() - Error: patches need the base geometry: " << e.what() << G4endl;
+            return;
+        }
+        break;
+    }
+
+    for (size_t i = 0; i < fVariants.size(); i++) {
+        const Variant& variant = fVariants[i];
+        G4cout << "GeometrySweep::Run() - Variant " << (i + 1) << "/" << fVariants.size()
+               << ": " << variant.label << G4endl;
+
+        G4bool rebuilt = false;
+        if (variant.patch.is_null()) {
+            fDetector->SetGeometryFile(variant.file);
+            rebuilt = fDetector->RebuildGeometry();
+        } else {
+            fDetector->SetGeometryFile(baseGeometry);
+            try {
+                json config = baseConfig;
+                if (variant.patch.is_array()) {
+                    config = baseConfig.patch(variant.patch);
+                } else {
+                    config.merge_patch(variant.patch);
+                }
+                rebuilt = fDetector->RebuildGeometry(config);
+            } catch (const std::exception& e) {
+                G4cerr << "GeometrySweep::Run() - Error applying " << variant.file << ": " << e.what() << G4endl;
+            }
+        }
+        if (!rebuilt) {
+            G4cerr << "GeometrySweep::Run() - Skipping variant " << variant.label << G4endl;
+            continue;
+        }
+
+        std::string output = (outputPath.parent_path() /
+            (outputPath.stem().string() + "_" + variant.label + outputPath.extension().string())).string();
+        uiManager->ApplyCommand("/output/setFileName " + output);
+        PhaseSpaceWriter::SetFileName(PhaseSpaceWriter::FileNameWithSuffix(basePhaseSpace, variant.label));
+        RunAction::SetMetadata("geometry_variant", variant.label);
+        RunAction::SetMetadata("geometry_source", variant.file);
+
+        runManager->BeamOn(nEvents);
+    }
+
+    // Back to the geometry and output the sweep started from
+    RunAction::RemoveMetadata("geometry_variant");
+    RunAction::RemoveMetadata("geometry_source");
+    uiManager->ApplyCommand("/output/setFileName " + baseOutput);
+    PhaseSpaceWriter::SetFileName(basePhaseSpace, false);
+    fDetector->SetGeometryFile(baseGeometry);
+    fDetector->RebuildGeometry();
+}
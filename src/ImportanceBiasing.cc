@@ -0,0 +1,112 @@
+/**
+ * @file ImportanceBiasing.cc
+ * @brief Implementation of the ImportanceBiasing class
+ */
+
+#include "ImportanceBiasing.hh"
+
+#include "G4GeometrySampler.hh"
+#include "G4IStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+
+#include <functional>
+#include <set>
+
+// ── Static members ──────────────────────────────────────
+G4bool ImportanceBiasing::fConfigured = false;
+std::map<const G4LogicalVolume*, G4double> ImportanceBiasing::fImportances;
+std::vector<G4String> ImportanceBiasing::fParticles;
+
+/**
+ * @brief Constructor implementation
+ */
+ImportanceBiasing::ImportanceBiasing()
+: G4VPhysicsConstructor("ImportanceBiasing")
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+ImportanceBiasing::~ImportanceBiasing()
+{}
+
+/**
+ * @brief Attach the importance process to the biased particles
+ * @details Called at /run/initialize after the geometry was constructed, so the
+ *          parser has registered the importances by now.  Without importances
+ *          nothing is attached and stepping is unaffected.
+ */
+void ImportanceBiasing::ConstructProcess()
+{
+  if (fImportances.empty()) return;
+
+  G4VPhysicalVolume* world =
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  std::vector<G4String> particles = fParticles;
+  if (particles.empty()) particles = {"neutron", "gamma"};
+
+  for (const auto& particle : particles) {
+    auto sampler = std::make_unique<G4GeometrySampler>(world, particle);
+    sampler->SetParallel(false);
+    sampler->PrepareImportanceSampling(G4IStore::GetInstance(), nullptr);
+    sampler->Configure();
+    fSamplers.push_back(std::move(sampler));
+    G4cout << "ImportanceBiasing::ConstructProcess() - Importance sampling for " << particle << G4endl;
+  }
+  fConfigured = true;
+}
+
+/**
+ * @brief Fill the importance store from the current geometry
+ * @details Every physical volume of the mass world gets a cell (one per copy of
+ *          replicas and parameterisations) with the importance of its logical
+ *          volume, 1 if none was given.  Called at the start of every run because
+ *          /detector/rebuild may have replaced the volumes.
+ */
+void ImportanceBiasing::BeginOfRun()
+{
+  if (!fConfigured) {
+    if (!fImportances.empty()) {
+      G4cerr << "ImportanceBiasing::BeginOfRun() - Warning: importance values were added after "
+             << "/run/initialize and are ignored" << G4endl;
+    }
+    return;
+  }
+
+  G4IStore* store = G4IStore::GetInstance();
+  store->SetWorldVolume();
+  store->Clear();
+
+  std::set<const G4VPhysicalVolume*> done;
+  G4int nCells = 0;
+  std::function<void(const G4VPhysicalVolume*)> addCells = [&](const G4VPhysicalVolume* pv) {
+    if (!done.insert(pv).second) return;
+
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+    auto it = fImportances.find(lv);
+    G4double importance = (it != fImportances.end()) ? it->second : 1.;
+
+    G4int multiplicity = pv->GetMultiplicity();
+    if (multiplicity > 1 || pv->IsReplicated()) {
+      for (G4int copy = 0; copy < multiplicity; copy++) {
+        store->AddImportanceGeometryCell(importance, *pv, copy);
+        nCells++;
+      }
+    } else {
+      store->AddImportanceGeometryCell(importance, *pv, pv->GetCopyNo());
+      nCells++;
+    }
+
+    for (size_t i = 0; i < lv->GetNoDaughters(); i++) {
+      addCells(lv->GetDaughter(i));
+    }
+  };
+  addCells(G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+
+  G4cout << "ImportanceBiasing::BeginOfRun() - " << nCells << " importance cell(s), "
+         << fImportances.size() << " volume(s) with explicit importance" << G4endl;
+}
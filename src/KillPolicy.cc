@@ -0,0 +1,315 @@
+/**
+ * @file KillPolicy.cc
+ * @brief Implementation of the KillPolicy class
+ */
+
+#include "KillPolicy.hh"
+
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4ios.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UImessenger.hh"
+
+#include <iomanip>
+
+// ── Static members ──────────────────────────────────────
+G4bool   KillPolicy::fKillNeutrinos = false;
+std::set<G4String> KillPolicy::fParticleNames;
+std::set<const G4ParticleDefinition*> KillPolicy::fParticles;
+G4double KillPolicy::fTimeWindow = 0.;
+G4double KillPolicy::fLowEnergy  = 0.;
+G4String KillPolicy::fRegionName = "";
+G4Region* KillPolicy::fRegion    = nullptr;
+std::array<std::atomic<G4long>, KillPolicy::kNRules> KillPolicy::fCounters{};
+bool KillPolicy::fMessengerCreated = false;
+KillPolicy::KillMessenger* KillPolicy::fMessenger = nullptr;
+
+// ── Nested messenger for the /kill/ commands ────────────
+class KillPolicy::KillMessenger : public G4UImessenger
+{
+public:
+  KillMessenger() {
+    fDir = new G4UIdirectory("/kill/");
+    fDir->SetGuidance("Track-killing rules (all off by default)");
+
+    fNeutrinosCmd = new G4UIcmdWithABool("/kill/neutrinos", this);
+    fNeutrinosCmd->SetGuidance("Kill neutrinos as soon as they are created");
+    fNeutrinosCmd->SetParameterName("flag", true);
+    fNeutrinosCmd->SetDefaultValue(true);
+
+    fParticleCmd = new G4UIcmdWithAString("/kill/particle", this);
+    fParticleCmd->SetGuidance("Add a particle to the kill list, e.g. /kill/particle anti_nu_e");
+    fParticleCmd->SetParameterName("particle", false);
+
+    fTimeWindowCmd = new G4UIcmdWithADoubleAndUnit("/kill/timeWindow", this);
+    fTimeWindowCmd->SetGuidance("Kill tracks beyond this global time (0 = off)");
+    fTimeWindowCmd->SetParameterName("time", false);
+    fTimeWindowCmd->SetRange("time>=0");
+    fTimeWindowCmd->SetDefaultUnit("ns");
+
+    fLowEnergyCmd = new G4UIcmdWithADoubleAndUnit("/kill/lowEnergy", this);
+    fLowEnergyCmd->SetGuidance("Kill particles below this kinetic energy outside sensitive volumes (0 = off)");
+    fLowEnergyCmd->SetGuidance("Particles with an at-rest process (e+, mu-, ions, ...) are kept");
+    fLowEnergyCmd->SetParameterName("energy", false);
+    fLowEnergyCmd->SetRange("energy>=0");
+    fLowEnergyCmd->SetDefaultUnit("keV");
+
+    fRegionCmd = new G4UIcmdWithAString("/kill/regionOfInterest", this);
+    fRegionCmd->SetGuidance("Kill tracks leaving this region (\"none\" = off)");
+    fRegionCmd->SetGuidance("Regions are defined in the \"regions\" array of the geometry JSON");
+    fRegionCmd->SetParameterName("region", false);
+
+    fResetCmd = new G4UIcommand("/kill/reset", this);
+    fResetCmd->SetGuidance("Switch all kill rules off");
+
+    fPrintCmd = new G4UIcommand("/kill/print", this);
+    fPrintCmd->SetGuidance("Print the kill rules and the tracks killed in the last run");
+  }
+  ~KillMessenger() override {
+    delete fNeutrinosCmd;
+    delete fParticleCmd;
+    delete fTimeWindowCmd;
+    delete fLowEnergyCmd;
+    delete fRegionCmd;
+    delete fResetCmd;
+    delete fPrintCmd;
+    delete fDir;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fNeutrinosCmd)
+      KillPolicy::SetKillNeutrinos(fNeutrinosCmd->GetNewBoolValue(val));
+    else if (cmd == fParticleCmd)
+      KillPolicy::AddParticle(val);
+    else if (cmd == fTimeWindowCmd)
+      KillPolicy::SetTimeWindow(fTimeWindowCmd->GetNewDoubleValue(val));
+    else if (cmd == fLowEnergyCmd)
+      KillPolicy::SetLowEnergy(fLowEnergyCmd->GetNewDoubleValue(val));
+    else if (cmd == fRegionCmd)
+      KillPolicy::SetRegionOfInterest(val);
+    else if (cmd == fResetCmd)
+      KillPolicy::Reset();
+    else if (cmd == fPrintCmd)
+      KillPolicy::Report();
+  }
+private:
+  G4UIdirectory*             fDir;
+  G4UIcmdWithABool*          fNeutrinosCmd;
+  G4UIcmdWithAString*        fParticleCmd;
+  G4UIcmdWithADoubleAndUnit* fTimeWindowCmd;
+  G4UIcmdWithADoubleAndUnit* fLowEnergyCmd;
+  G4UIcmdWithAString*        fRegionCmd;
+  G4UIcommand*               fResetCmd;
+  G4UIcommand*               fPrintCmd;
+};
+
+/**
+ * @brief Create the /kill/ messenger (once)
+ */
+void KillPolicy::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new KillMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Switch all rules off
+ */
+void KillPolicy::Reset()
+{
+  fKillNeutrinos = false;
+  fParticleNames.clear();
+  fParticles.clear();
+  fTimeWindow = 0.;
+  fLowEnergy  = 0.;
+  fRegionName = "";
+  fRegion     = nullptr;
+}
+
+/**
+ * @brief Resolve particle and region names and reset the counters
+ * @details Called by the master RunAction; the geometry may have been rebuilt
+ *          since the last run, so the region is looked up again every time.
+ */
+void KillPolicy::BeginOfRun()
+{
+  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  fParticles.clear();
+  if (fKillNeutrinos) {
+    for (const char* name : {"nu_e", "anti_nu_e", "nu_mu", "anti_nu_mu", "nu_tau", "anti_nu_tau"}) {
+      if (auto* particle = particleTable->FindParticle(name)) fParticles.insert(particle);
+    }
+  }
+  for (const auto& name : fParticleNames) {
+    auto* particle = particleTable->FindParticle(name);
+    if (particle) {
+      fParticles.insert(particle);
+    } else {
+      G4cerr << "KillPolicy::BeginOfRun() - Warning: unknown particle " << name << " in kill list" << G4endl;
+    }
+  }
+
+  fRegion = nullptr;
+  if (!fRegionName.empty()) {
+    fRegion = G4RegionStore::GetInstance()->GetRegion(fRegionName, false);
+    if (!fRegion) {
+      G4cerr << "KillPolicy::BeginOfRun() - Warning: region of interest " << fRegionName
+             << " does not exist; rule disabled" << G4endl;
+    }
+  }
+
+  for (auto& counter : fCounters) counter = 0;
+}
+
+/**
+ * @brief True if the low-energy rule may kill this track here
+ * @param track Track to check
+ * @param energy Kinetic energy of the track
+ * @param volume Volume the track is in (may be null)
+ * @return True if the track is below the limit outside a sensitive volume and
+ *         has nothing left to do at rest
+ */
+G4bool KillPolicy::IsLowEnergyKill(const G4Track* track, G4double energy,
+                                   const G4VPhysicalVolume* volume)
+{
+  if (energy >= fLowEnergy || !volume) return false;
+  if (volume->GetLogicalVolume()->GetSensitiveDetector()) return false;
+
+  // Positrons still annihilate, ions still decay: their products may reach a detector
+  G4ProcessManager* pm = track->GetDefinition()->GetProcessManager();
+  if (pm && pm->GetAtRestProcessVector()->entries() > 0) return false;
+  return true;
+}
+
+/**
+ * @brief Rule that kills a new track, if any
+ * @param track Track about to be stacked
+ * @return Rule index, or -1 if the track is kept
+ */
+G4int KillPolicy::CheckNewTrack(const G4Track* track)
+{
+  if (!fParticles.empty() && fParticles.count(track->GetDefinition())) return kParticle;
+  if (fTimeWindow > 0 && track->GetGlobalTime() > fTimeWindow) return kTimeWindow;
+  // Secondaries carry the touchable of their creation point; primaries are not located yet
+  if (fLowEnergy > 0 && IsLowEnergyKill(track, track->GetKineticEnergy(), track->GetVolume())) return kLowEnergy;
+  return -1;
+}
+
+/**
+ * @brief Rule that kills the track after this step, if any
+ * @param step Step just taken
+ * @return Rule index, or -1 if the track is kept
+ */
+G4int KillPolicy::CheckStep(const G4Step* step)
+{
+  const G4StepPoint* post = step->GetPostStepPoint();
+  if (fTimeWindow > 0 && post->GetGlobalTime() > fTimeWindow) return kTimeWindow;
+
+  const G4VPhysicalVolume* postVolume = post->GetPhysicalVolume();
+  if (!postVolume) return -1;   // leaving the world
+
+  if (fLowEnergy > 0 && post->GetKineticEnergy() > 0 &&
+      IsLowEnergyKill(step->GetTrack(), post->GetKineticEnergy(), postVolume)) return kLowEnergy;
+
+  if (fRegion && post->GetStepStatus() == fGeomBoundary &&
+      step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetRegion() == fRegion &&
+      postVolume->GetLogicalVolume()->GetRegion() != fRegion) return kRegion;
+  return -1;
+}
+
+/**
+ * @brief Short name of a rule
+ * @param rule Rule index
+ * @return Name used in the report and the output metadata
+ */
+const char* KillPolicy::RuleName(G4int rule)
+{
+  switch (rule) {
+    case kParticle:   return "particle";
+    case kTimeWindow: return "time_window";
+    case kLowEnergy:  return "low_energy";
+    case kRegion:     return "region";
+    default:          return "unknown";
+  }
+}
+
+/**
+ * @brief True if the rule is switched on
+ * @param rule Rule index
+ */
+G4bool KillPolicy::IsActive(G4int rule)
+{
+  switch (rule) {
+    case kParticle:   return fKillNeutrinos || !fParticleNames.empty();
+    case kTimeWindow: return fTimeWindow > 0;
+    case kLowEnergy:  return fLowEnergy > 0;
+    case kRegion:     return !fRegionName.empty();
+    default:          return false;
+  }
+}
+
+/**
+ * @brief Killed-track counts of the active rules
+ * @return Map of rule name to number of killed tracks
+ */
+std::map<std::string, G4long> KillPolicy::Counters()
+{
+  std::map<std::string, G4long> counters;
+  for (G4int rule = 0; rule < kNRules; rule++) {
+    if (IsActive(rule)) counters[RuleName(rule)] = fCounters[rule];
+  }
+  return counters;
+}
+
+/**
+ * @brief Print the active rules and the number of tracks each killed
+ */
+void KillPolicy::Report()
+{
+  G4bool any = false;
+  for (G4int rule = 0; rule < kNRules; rule++) any = any || IsActive(rule);
+  if (!any) {
+    G4cout << "KillPolicy - no kill rules active" << G4endl;
+    return;
+  }
+
+  G4cout << "KillPolicy - killed tracks per rule:" << G4endl;
+  for (G4int rule = 0; rule < kNRules; rule++) {
+    if (!IsActive(rule)) continue;
+    G4cout << "  " << std::setw(12) << std::left << RuleName(rule) << std::right
+           << std::setw(12) << fCounters[rule].load() << "  (";
+    switch (rule) {
+      case kParticle:
+        if (fKillNeutrinos) G4cout << "neutrinos ";
+        for (const auto& name : fParticleNames) G4cout << name << " ";
+        break;
+      case kTimeWindow:
+        G4cout << "t > " << G4BestUnit(fTimeWindow, "Time");
+        break;
+      case kLowEnergy:
+        G4cout << "E < " << G4BestUnit(fLowEnergy, "Energy") << " outside sensitive volumes";
+        break;
+      case kRegion:
+        G4cout << "leaving " << fRegionName;
+        break;
+    }
+    G4cout << ")" << G4endl;
+  }
+}
@@ -11,7 +11,8 @@ MyHit::MyHit()
   fVolumeName(""),
   fPosition(G4ThreeVector()),
   fEnergy(0.),
-  fTime(0.)
+  fTime(0.),
+  fWeight(1.)
 {}
 
 /**
@@ -29,6 +30,7 @@ MyHit::MyHit(const MyHit& right)
   fPosition = right.fPosition;
   fEnergy = right.fEnergy;
   fTime = right.fTime;
+  fWeight = right.fWeight;
 }
 
 /**
@@ -40,6 +42,7 @@ const MyHit& MyHit::operator=(const MyHit& right) {
   fPosition = right.fPosition;
   fEnergy = right.fEnergy;
   fTime = right.fTime;
+  fWeight = right.fWeight;
   return *this;
 }
 
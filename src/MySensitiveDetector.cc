@@ -1,6 +1,8 @@
 #include "MySensitiveDetector.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
 #include "G4ThreeVector.hh"
 #include "G4SDManager.hh"
 #include "G4ios.hh"
@@ -98,10 +100,20 @@ G4bool MySensitiveDetector::ProcessHits(G4Step* step, G4TouchableHistory*)
   
   // Set hit properties
   hit->SetTrackID(step->GetTrack()->GetTrackID());
-  hit->SetVolumeName(step->GetPreStepPoint()->GetPhysicalVolume()->GetName());
+
+  // Copies of a parameterised array share one physical volume; tell them
+  // apart by appending the copy number
+  const G4StepPoint* preStep = step->GetPreStepPoint();
+  const G4VPhysicalVolume* physVol = preStep->GetPhysicalVolume();
+  if (physVol->IsParameterised()) {
+    hit->SetVolumeName(physVol->GetName() + "_" + std::to_string(preStep->GetTouchable()->GetCopyNumber()));
+  } else {
+    hit->SetVolumeName(physVol->GetName());
+  }
   hit->SetPosition(step->GetPostStepPoint()->GetPosition());
   hit->SetEnergy(edep);
   hit->SetTime(step->GetPostStepPoint()->GetGlobalTime());
+  hit->SetWeight(preStep->GetWeight());
   
   // Add hit to collection
   fHitsCollection->insert(hit);
@@ -130,6 +142,7 @@ void MySensitiveDetector::EndOfEvent(G4HCofThisEvent*)
              << " at position " << hit->GetPosition()/mm << " mm"
              << " with energy " << hit->GetEnergy()/keV << " keV"
              << " at time " << hit->GetTime()/ns << " ns"
+             << " with weight " << hit->GetWeight()
              << G4endl;
     }
   }
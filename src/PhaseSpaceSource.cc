@@ -0,0 +1,222 @@
+/**
+ * @file PhaseSpaceSource.cc
+ * @brief Implementation of the PhaseSpaceSource class
+ */
+
+#include "PhaseSpaceSource.hh"
+#include "RunAction.hh"
+#include "SimRunManager.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4Geantino.hh"
+#include "G4Threading.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+
+// ── Static members ──────────────────────────────────────
+G4String PhaseSpaceSource::fFileName  = "phasespace.bin";
+G4bool   PhaseSpaceSource::fRandom    = false;
+G4bool   PhaseSpaceSource::fRandomPhi = false;
+
+/**
+ * @brief Constructor implementation
+ */
+PhaseSpaceSource::PhaseSpaceSource()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+PhaseSpaceSource::~PhaseSpaceSource()
+{}
+
+/**
+ * @brief Open fFileName and check its header
+ * @return True if the file holds at least one record
+ * @details Sequential replay is split like event files: each worker thread (of
+ *          each forked process) replays its own contiguous range of records, cut at
+ *          original-event boundaries, and starts over within it.  The file name and its number of primaries are stored
+ *          as run metadata for normalisation.
+ */
+G4bool PhaseSpaceSource::Open()
+{
+  if (fFile.is_open()) fFile.close();
+  fOpenFileName = fFileName;
+  fNRecords = 0;
+  fNext = 0;
+  fFirst = 0;
+  fEnd = 0;
+
+  fFile.open(fOpenFileName, std::ios::binary);
+  char magic[sizeof(PhaseSpaceRecord::kMagic)];
+  uint32_t version = 0, recordSize = 0;
+  uint64_t nPrimaries = 0;
+  fFile.read(magic, sizeof(magic));
+  fFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+  fFile.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+  fFile.read(reinterpret_cast<char*>(&nPrimaries), sizeof(nPrimaries));
+  if (!fFile || std::memcmp(magic, PhaseSpaceRecord::kMagic, sizeof(magic)) != 0 ||
+      version != PhaseSpaceRecord::kVersion || recordSize != PhaseSpaceRecord::kRecordSize) {
+    G4cerr << "PhaseSpaceSource::Open() - Error: " << fOpenFileName
+           << " is not a phase-space file of version " << PhaseSpaceRecord::kVersion << G4endl;
+    fFile.close();
+    return false;
+  }
+
+  fFile.seekg(0, std::ios::end);
+  fNRecords = (uint64_t(fFile.tellg()) - PhaseSpaceRecord::kHeaderSize) / PhaseSpaceRecord::kRecordSize;
+  if (fNRecords == 0) {
+    G4cerr << "PhaseSpaceSource::Open() - Error: " << fOpenFileName << " holds no records" << G4endl;
+    fFile.close();
+    return false;
+  }
+
+  uint64_t nParts = 1;
+  uint64_t part = 0;
+  if (G4Threading::IsWorkerThread()) {
+    nParts = std::max(1, G4Threading::GetNumberOfRunningWorkerThreads());
+    part = G4Threading::G4GetThreadId();
+  }
+  if (SimRunManager::GetProcessIndex() >= 0) {
+    part += nParts * SimRunManager::GetProcessIndex();
+    nParts *= SimRunManager::GetNumberOfProcesses();
+  }
+  fFirst = AlignToEvent(fNRecords * part / nParts);
+  fEnd = AlignToEvent(fNRecords * (part + 1) / nParts);
+  fNext = fFirst;
+  if (!fRandom && fFirst >= fEnd) {
+    G4cerr << "PhaseSpaceSource::Open() - Error: " << fOpenFileName << " has too few events to "
+           << "give this thread/process its own share" << G4endl;
+    fFile.close();
+    return false;
+  }
+
+  RunAction::SetMetadata("phasespace_file", fOpenFileName);
+  RunAction::SetMetadata("phasespace_primaries", std::to_string(nPrimaries));
+  G4cout << "PhaseSpaceSource::Open() - " << fOpenFileName << ": " << fNRecords
+         << " record(s) from " << nPrimaries << " primary event(s)" << G4endl;
+  return true;
+}
+
+/**
+ * @brief Read record i into the record
+ * @param i Record index
+ * @param record Record to fill
+ * @return False on a read error
+ */
+G4bool PhaseSpaceSource::ReadRecord(uint64_t i, PhaseSpaceRecord& record)
+{
+  char buffer[PhaseSpaceRecord::kRecordSize];
+  fFile.seekg(PhaseSpaceRecord::kHeaderSize + i * PhaseSpaceRecord::kRecordSize);
+  fFile.read(buffer, sizeof(buffer));
+  if (!fFile) {
+    fFile.clear();
+    return false;
+  }
+  record.Unpack(buffer);
+  return true;
+}
+
+/**
+ * @brief First record of an original event at or after record i
+ * @param i Record index
+ * @return Index of the first record not belonging to the event of record i-1
+ */
+uint64_t PhaseSpaceSource::AlignToEvent(uint64_t i)
+{
+  if (i == 0 || i >= fNRecords) return std::min(i, fNRecords);
+  PhaseSpaceRecord previous, record;
+  if (!ReadRecord(i - 1, previous)) return fNRecords;
+  for (; i < fNRecords; i++) {
+    if (!ReadRecord(i, record) || record.event != previous.event) break;
+  }
+  return i;
+}
+
+/**
+ * @brief Particle definition of a PDG code
+ * @param pdg PDG encoding; 0 stands for the geantino
+ * @return Particle definition, or nullptr if unknown
+ */
+const G4ParticleDefinition* PhaseSpaceSource::FindParticle(G4int pdg)
+{
+  if (pdg == 0) return G4Geantino::Definition();
+  if (pdg > 1000000000) return G4IonTable::GetIonTable()->GetIon(pdg);
+  return G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+}
+
+/**
+ * @brief Add a record as a primary vertex to the event
+ * @param event Event to add the primary to
+ * @param record Phase-space record
+ * @param phi Rotation about the z axis
+ */
+void PhaseSpaceSource::AddPrimary(G4Event* event, const PhaseSpaceRecord& record, G4double phi) const
+{
+  const G4ParticleDefinition* particle = FindParticle(record.pdg);
+  if (!particle) {
+    G4cerr << "PhaseSpaceSource::AddPrimary() - Warning: unknown PDG code " << record.pdg
+           << ", record skipped" << G4endl;
+    return;
+  }
+
+  G4ThreeVector position = record.position;
+  G4ThreeVector direction = record.direction;
+  if (phi != 0.) {
+    position.rotateZ(phi);
+    direction.rotateZ(phi);
+  }
+
+  auto* vertex = new G4PrimaryVertex(position, record.time);
+  auto* primary = new G4PrimaryParticle(particle);
+  primary->SetKineticEnergy(record.energy);
+  primary->SetMomentumDirection(direction.unit());
+  primary->SetWeight(record.weight);
+  vertex->SetPrimary(primary);
+  event->AddPrimaryVertex(vertex);
+}
+
+/**
+ * @brief Add the next particle(s) from the file to the event
+ * @param event Event to add the primaries to
+ */
+void PhaseSpaceSource::GeneratePrimaries(G4Event* event)
+{
+  if ((!fFile.is_open() || fOpenFileName != fFileName) && !Open()) {
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
+  }
+
+  PhaseSpaceRecord record;
+  G4double phi = fRandomPhi ? twopi * G4UniformRand() : 0.;
+
+  if (fRandom) {
+    uint64_t i = std::min<uint64_t>(uint64_t(G4UniformRand() * fNRecords), fNRecords - 1);
+    if (ReadRecord(i, record)) AddPrimary(event, record, phi);
+    return;
+  }
+
+  // Sequential: all consecutive records of the same original event
+  G4int originalEvent = 0;
+  for (G4bool first = true;; first = false) {
+    if (fNext >= fEnd) {
+      if (!first) break;
+      G4cout << "PhaseSpaceSource::GeneratePrimaries() - End of the share of " << fOpenFileName
+             << " reached, starting over" << G4endl;
+      fNext = fFirst;
+    }
+    if (!ReadRecord(fNext, record)) break;
+    if (!first && record.event != originalEvent) break;
+    originalEvent = record.event;
+    AddPrimary(event, record, phi);
+    fNext++;
+  }
+}
@@ -0,0 +1,242 @@
+/**
+ * @file PhaseSpaceWriter.cc
+ * @brief Implementation of the PhaseSpaceWriter class
+ */
+
+#include "PhaseSpaceWriter.hh"
+#include "PhaseSpaceRecord.hh"
+#include "SimRunManager.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UImessenger.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+// ── Static members ──────────────────────────────────────
+G4String PhaseSpaceWriter::fFileName = "phasespace.bin";
+std::set<std::string> PhaseSpaceWriter::fWritten;
+std::map<const G4LogicalVolume*, G4bool> PhaseSpaceWriter::fSurfaces;
+G4ThreadLocal PhaseSpaceWriter* PhaseSpaceWriter::fInstance = nullptr;
+bool PhaseSpaceWriter::fMessengerCreated = false;
+PhaseSpaceWriter::PhaseSpaceMessenger* PhaseSpaceWriter::fMessenger = nullptr;
+
+// ── Nested messenger for the /phasespace/ commands ──────
+class PhaseSpaceWriter::PhaseSpaceMessenger : public G4UImessenger
+{
+public:
+  PhaseSpaceMessenger() {
+    fDir = new G4UIdirectory("/phasespace/");
+    fDir->SetGuidance("Phase-space recording at record_surface volumes");
+
+    fFileNameCmd = new G4UIcmdWithAString("/phasespace/setFileName", this);
+    fFileNameCmd->SetGuidance("Set the phase-space output file (default phasespace.bin)");
+    fFileNameCmd->SetGuidance("Worker threads write <stem>_t<id><ext>");
+    fFileNameCmd->SetGuidance("The file is created at the next run; later runs append to it");
+    fFileNameCmd->SetParameterName("FileName", false);
+  }
+  ~PhaseSpaceMessenger() override { delete fFileNameCmd; delete fDir; }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fFileNameCmd)
+      PhaseSpaceWriter::SetFileName(val);
+  }
+private:
+  G4UIdirectory*      fDir;
+  G4UIcmdWithAString* fFileNameCmd;
+};
+
+/**
+ * @brief Create the /phasespace/ messenger (once)
+ */
+void PhaseSpaceWriter::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new PhaseSpaceMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+namespace {
+G4Mutex writtenMutex = G4MUTEX_INITIALIZER;
+}
+
+/**
+ * @brief Set the output file name
+ * @param name File name
+ * @param restart Create the file afresh at the next run instead of appending
+ */
+void PhaseSpaceWriter::SetFileName(const G4String& name, G4bool restart)
+{
+  G4AutoLock lock(&writtenMutex);
+  fFileName = name;
+  if (!restart) return;
+  // Also the per-thread files of this name
+  const std::filesystem::path path(std::string(name));
+  const std::string threadPrefix = (path.parent_path() / (path.stem().string() + "_t")).string();
+  for (auto it = fWritten.begin(); it != fWritten.end();) {
+    it = (*it == std::string(name) || it->rfind(threadPrefix, 0) == 0) ? fWritten.erase(it) : std::next(it);
+  }
+}
+
+/**
+ * @brief File name with a suffix added to its stem
+ * @param name File name
+ * @param suffix Suffix, e.g. a sweep point
+ * @return <stem>_<suffix><ext>
+ */
+G4String PhaseSpaceWriter::FileNameWithSuffix(const G4String& name, const std::string& suffix)
+{
+  const std::filesystem::path path(std::string(name));
+  return (path.parent_path() / (path.stem().string() + "_" + suffix + path.extension().string())).string();
+}
+
+/**
+ * @brief Note that child processes recorded a run: later runs append
+ * @details Called by the parent process, whose writer does not run; the children
+ *          of the next run inherit the note and append to their shards.
+ */
+void PhaseSpaceWriter::MarkWritten()
+{
+  G4AutoLock lock(&writtenMutex);
+  if (!fSurfaces.empty()) fWritten.insert(fFileName);
+}
+
+/**
+ * @brief Writer of the calling thread
+ * @return Thread-local instance, created on first use
+ */
+PhaseSpaceWriter* PhaseSpaceWriter::Instance()
+{
+  if (!fInstance) fInstance = new PhaseSpaceWriter();
+  return fInstance;
+}
+
+/**
+ * @brief Open the output file if record surfaces are defined
+ * @details The first run of the job creates the file; later runs append to it,
+ *          continuing from the primary count in its header.
+ */
+void PhaseSpaceWriter::BeginOfRun()
+{
+  if (fFile.is_open() || fSurfaces.empty()) return;
+
+  std::string name = fFileName;
+  if (G4Threading::IsWorkerThread()) {
+    std::filesystem::path path(name);
+    name = (path.parent_path() / (path.stem().string() + "_t" +
+        std::to_string(G4Threading::G4GetThreadId()) + path.extension().string())).string();
+  }
+  G4bool append;
+  {
+    G4AutoLock lock(&writtenMutex);
+    append = !fWritten.insert(name).second;
+  }
+  fOpenFileName = SimRunManager::ShardFileName(name);
+
+  // Primary count of the earlier runs, if the file is there to append to
+  fNPrimariesBefore = 0;
+  if (append) {
+    std::ifstream existing(fOpenFileName, std::ios::binary);
+    char magic[sizeof(PhaseSpaceRecord::kMagic)];
+    existing.read(magic, sizeof(magic));
+    existing.seekg(16);
+    existing.read(reinterpret_cast<char*>(&fNPrimariesBefore), sizeof(fNPrimariesBefore));
+    if (!existing || std::memcmp(magic, PhaseSpaceRecord::kMagic, sizeof(magic)) != 0) {
+      append = false;
+      fNPrimariesBefore = 0;
+    }
+  }
+
+  fBuffer.resize(1 << 20);
+  fFile.rdbuf()->pubsetbuf(fBuffer.data(), fBuffer.size());
+  fFile.open(fOpenFileName, std::ios::binary | (append ? std::ios::in : std::ios::trunc));
+  if (!fFile) {
+    G4cerr << "PhaseSpaceWriter::BeginOfRun() - Error: cannot open " << fOpenFileName << G4endl;
+    return;
+  }
+  fNRecords = 0;
+
+  if (append) {
+    fFile.seekp(0, std::ios::end);
+  } else {
+    // Header; the number of primaries is filled in at the end of the run
+    uint32_t version = PhaseSpaceRecord::kVersion;
+    uint32_t recordSize = PhaseSpaceRecord::kRecordSize;
+    uint64_t nPrimaries = 0;
+    fFile.write(PhaseSpaceRecord::kMagic, sizeof(PhaseSpaceRecord::kMagic));
+    fFile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    fFile.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+    fFile.write(reinterpret_cast<const char*>(&nPrimaries), sizeof(nPrimaries));
+  }
+
+  G4cout << "PhaseSpaceWriter::BeginOfRun() - Recording " << fSurfaces.size() << " surface(s) to "
+         << fOpenFileName << (append ? " (appending)" : "") << G4endl;
+}
+
+/**
+ * @brief Close the file and store the number of primary events in the header
+ * @param nEvents Number of events simulated by this thread
+ */
+void PhaseSpaceWriter::EndOfRun(G4int nEvents)
+{
+  if (!fFile.is_open()) return;
+
+  uint64_t nPrimaries = fNPrimariesBefore + nEvents;
+  fFile.seekp(16);
+  fFile.write(reinterpret_cast<const char*>(&nPrimaries), sizeof(nPrimaries));
+  fFile.close();
+
+  G4cout << "PhaseSpaceWriter::EndOfRun() - " << fNRecords << " particle(s) from "
+         << nEvents << " event(s) written to " << fOpenFileName << G4endl;
+}
+
+/**
+ * @brief Write the track if it enters a record surface in this step
+ * @param step Step just taken
+ * @return True if the track has to be killed after recording
+ */
+G4bool PhaseSpaceWriter::Record(const G4Step* step)
+{
+  const G4StepPoint* post = step->GetPostStepPoint();
+  if (post->GetStepStatus() != fGeomBoundary) return false;
+
+  const G4VPhysicalVolume* postVolume = post->GetPhysicalVolume();
+  if (!postVolume) return false;
+
+  auto it = fSurfaces.find(postVolume->GetLogicalVolume());
+  if (it == fSurfaces.end()) return false;
+  if (step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume() == it->first) return false;
+
+  if (fFile.is_open()) {
+    const G4Track* track = step->GetTrack();
+    const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+
+    PhaseSpaceRecord record;
+    record.event     = G4int(fNPrimariesBefore) + (event ? event->GetEventID() : 0);
+    record.pdg       = track->GetDefinition()->GetPDGEncoding();
+    record.energy    = post->GetKineticEnergy();
+    record.position  = post->GetPosition();
+    record.direction = post->GetMomentumDirection();
+    record.time      = post->GetGlobalTime();
+    record.weight    = track->GetWeight();
+
+    char buffer[PhaseSpaceRecord::kRecordSize];
+    record.Pack(buffer);
+    fFile.write(buffer, sizeof(buffer));
+    fNRecords++;
+  }
+  return it->second;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file PhysicsTableCache.cc
+ * @brief Implementation of the PhysicsTableCache class
+ */
+
+#include "PhysicsTableCache.hh"
+#include "RunAction.hh"
+#include "json.hpp"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4EmParameters.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4ProductionCuts.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4IonisParamMat.hh"
+#include "G4Version.hh"
+#include "G4ios.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UImessenger.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// ── Static members ──────────────────────────────────────
+G4String PhysicsTableCache::fDirectory       = "";
+G4String PhysicsTableCache::fPhysicsListName = "";
+G4String PhysicsTableCache::fEntry           = "";
+G4bool   PhysicsTableCache::fHit             = false;
+G4bool   PhysicsTableCache::fDone            = false;
+bool PhysicsTableCache::fMessengerCreated = false;
+PhysicsTableCache::CacheMessenger* PhysicsTableCache::fMessenger = nullptr;
+
+// ── Nested messenger for the /physics/ commands ─────────
+class PhysicsTableCache::CacheMessenger : public G4UImessenger
+{
+public:
+  CacheMessenger() {
+    fDir = new G4UIdirectory("/physics/");
+    fDir->SetGuidance("Physics table cache");
+
+    fCacheCmd = new G4UIcmdWithAString("/physics/setTableCache", this);
+    fCacheCmd->SetGuidance("Directory of the physics table cache (\"none\" = off)");
+    fCacheCmd->SetGuidance("The first run retrieves the tables stored there for the same physics list,");
+    fCacheCmd->SetGuidance("cuts and materials, or builds and stores them; set before the first /run/beamOn");
+    fCacheCmd->SetParameterName("Directory", false);
+  }
+  ~CacheMessenger() override {
+    delete fCacheCmd;
+    delete fDir;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fCacheCmd)
+      PhysicsTableCache::SetDirectory(val);
+  }
+private:
+  G4UIdirectory*      fDir;
+  G4UIcmdWithAString* fCacheCmd;
+};
+
+/**
+ * @brief Create the /physics/ commands (once)
+ */
+void PhysicsTableCache::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new CacheMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Everything the tables depend on, as text
+ * @return Geant4 version, physics list, EM parameters, region cuts and materials
+ */
+std::string PhysicsTableCache::KeyText()
+{
+  std::ostringstream text;
+  text << "geant4 " << G4Version << ' ' << G4VERSION_NUMBER << '\n'
+       << "physics " << fPhysicsListName << '\n';
+  G4EmParameters::Instance()->StreamInfo(text);
+
+  text << std::setprecision(17);
+  const G4ProductionCutsTable* cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  text << "energy_range " << cutsTable->GetLowEdgeEnergy() << ' ' << cutsTable->GetHighEdgeEnergy() << '\n';
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    text << "region " << region->GetName();
+    if (const G4ProductionCuts* cuts = region->GetProductionCuts()) {
+      for (const char* particle : {"gamma", "e-", "e+", "proton"}) {
+        text << ' ' << cuts->GetProductionCut(particle);
+      }
+    }
+    text << '\n';
+  }
+
+  for (const G4Material* material : *G4Material::GetMaterialTable()) {
+    text << "material " << material->GetName() << ' ' << material->GetDensity() << ' '
+         << material->GetState() << ' ' << material->GetTemperature() << ' '
+         << material->GetPressure() << ' ' << material->GetIonisation()->GetMeanExcitationEnergy();
+    const G4double* fractions = material->GetFractionVector();
+    for (size_t i = 0; i < material->GetNumberOfElements(); i++) {
+      const G4Element* element = material->GetElement(i);
+      text << ' ' << element->GetName() << ' ' << element->GetZ() << ' ' << element->GetN()
+           << ' ' << fractions[i];
+    }
+    text << '\n';
+  }
+  return text.str();
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a text
+ * @param text Text to hash
+ * @return Hash as 16 hex digits
+ */
+std::string PhysicsTableCache::Hash(const std::string& text)
+{
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return hex.str();
+}
+
+/**
+ * @brief Select retrieval of cached tables for the first run, if there are any
+ * @param physicsList Physics list about to build its tables
+ */
+void PhysicsTableCache::BeforeBuild(G4VUserPhysicsList* physicsList)
+{
+  if (fDone || fDirectory.empty() || !physicsList) return;
+  fDone = true;
+
+  const std::string name = fPhysicsListName.empty() ? std::string("physics") : std::string(fPhysicsListName);
+  fEntry = (fs::path(std::string(fDirectory)) / (name + "_" + Hash(KeyText()))).string();
+
+  // An entry is complete once its cache.json exists (it is written last)
+  std::error_code error;
+  fHit = fs::exists(fs::path(std::string(fEntry)) / "cache.json", error);
+  if (fHit) {
+    physicsList->SetPhysicsTableRetrieved(fEntry);
+  } else {
+    physicsList->ResetPhysicsTableRetrieved();
+  }
+}
+
+/**
+ * @brief Report the outcome and store the tables on a miss
+ * @param physicsList Physics list whose tables were built or retrieved
+ * @param seconds Time taken by the run initialisation
+ */
+void PhysicsTableCache::AfterBuild(G4VUserPhysicsList* physicsList, G4double seconds)
+{
+  if (fEntry.empty()) return;
+  const std::string entry = fEntry;
+  fEntry = "";
+
+  RunAction::SetMetadata("physics_table_cache", fHit ? "hit" : "miss");
+  RunAction::SetMetadata("physics_tables_s", std::to_string(seconds));
+
+  // Formatted apart, so that G4cout keeps its precision
+  std::ostringstream time;
+  time << std::setprecision(3) << seconds << " s";
+
+  if (fHit) {
+    // Later runs that need new tables build them normally
+    physicsList->ResetPhysicsTableRetrieved();
+    G4cout << "PhysicsTableCache - Hit: tables retrieved from " << entry << " in " << time.str() << G4endl;
+    return;
+  }
+  G4cout << "PhysicsTableCache - Miss: tables built in " << time.str() << ", storing them in " << entry << G4endl;
+
+  // Store under a temporary name and rename it into place, so that other
+  // jobs never retrieve from a half-written entry
+  const auto start = std::chrono::steady_clock::now();
+  const std::string tmp = entry + ".tmp" + std::to_string(::getpid());
+  std::error_code error;
+  fs::create_directories(tmp, error);
+  if (error || !physicsList->StorePhysicsTable(tmp)) {
+    G4cerr << "PhysicsTableCache::AfterBuild() - Error: cannot store the tables in " << tmp << G4endl;
+    fs::remove_all(tmp, error);
+    return;
+  }
+
+  nlohmann::json info;
+  info["physics_list"] = std::string(fPhysicsListName);
+  info["geant4"] = std::string(G4Version);
+  info["build_s"] = seconds;
+  info["created"] = std::time(nullptr);
+  {
+    std::ofstream out(fs::path(tmp) / "cache.json", std::ios::trunc);
+    out << info.dump(2) << '\n';
+  }
+  {
+    std::ofstream out(fs::path(tmp) / "key.txt", std::ios::trunc);
+    out << KeyText();
+  }
+
+  fs::rename(tmp, entry, error);
+  if (error) {
+    // Another job stored the same entry first
+    fs::remove_all(tmp, error);
+    return;
+  }
+  G4cout << "PhysicsTableCache - Tables stored in "
+         << std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count()
+         << " s" << G4endl;
+}
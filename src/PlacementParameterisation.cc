@@ -0,0 +1,43 @@
+/**
+ * @file PlacementParameterisation.cc
+ * @brief Implementation of the PlacementParameterisation class
+ */
+
+#include "PlacementParameterisation.hh"
+#include "G4VPhysicalVolume.hh"
+
+/**
+ * @brief Constructor implementation
+ * @param positions Position of each copy in the mother frame
+ * @param rotations Rotation of each copy (nullptr for none)
+ */
+PlacementParameterisation::PlacementParameterisation(const std::vector<G4ThreeVector>& positions,
+                                                     const std::vector<G4RotationMatrix*>& rotations)
+: G4VPVParameterisation(),
+  fPositions(positions),
+  fRotations(rotations)
+{
+    fRotations.resize(fPositions.size(), nullptr);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+PlacementParameterisation::~PlacementParameterisation()
+{
+    for (auto* rotation : fRotations) {
+        delete rotation;
+    }
+}
+
+/**
+ * @brief Set the translation and rotation of copy number copyNo
+ * @param copyNo Copy number of the volume
+ * @param physVol Parameterised physical volume to update
+ */
+void PlacementParameterisation::ComputeTransformation(const G4int copyNo,
+                                                      G4VPhysicalVolume* physVol) const
+{
+    physVol->SetTranslation(fPositions[copyNo]);
+    physVol->SetRotation(fRotations[copyNo]);
+}
@@ -8,10 +8,152 @@
  */
 
 #include "PrimaryGeneratorAction.hh"
+#include "SourceSweep.hh"
+#include "DecayWindow.hh"
+#include "PhaseSpaceSource.hh"
+#include "EventFileSource.hh"
+#include "ConfinementSampler.hh"
 
 #include "G4GeneralParticleSource.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UImessenger.hh"
+
+// ── Static members ──────────────────────────────────────
+SourceSweep* PrimaryGeneratorAction::fSourceSweep = nullptr;
+G4String PrimaryGeneratorAction::fSourceType = "gps";
+PrimaryGeneratorAction::SourceMessenger* PrimaryGeneratorAction::fMessenger = nullptr;
+
+// ── Nested messenger for the /source/ commands ──────────
+class PrimaryGeneratorAction::SourceMessenger : public G4UImessenger
+{
+public:
+  SourceMessenger() {
+    fDir = new G4UIdirectory("/source/");
+    fDir->SetGuidance("Primary source selection");
+
+    fTypeCmd = new G4UIcmdWithAString("/source/type", this);
+    fTypeCmd->SetGuidance("gps: General Particle Source (default)");
+    fTypeCmd->SetGuidance("phasespace: replay a phase-space file written at a record surface");
+    fTypeCmd->SetGuidance("file: read pre-generated events (binary or HepMC3 ASCII)");
+    fTypeCmd->SetParameterName("type", false);
+    fTypeCmd->SetCandidates("gps phasespace file");
+
+    fPhaseSpaceDir = new G4UIdirectory("/source/phasespace/");
+    fPhaseSpaceDir->SetGuidance("Phase-space replay settings");
+
+    fFileCmd = new G4UIcmdWithAString("/source/phasespace/file", this);
+    fFileCmd->SetGuidance("Phase-space file to replay");
+    fFileCmd->SetParameterName("FileName", false);
+
+    fModeCmd = new G4UIcmdWithAString("/source/phasespace/mode", this);
+    fModeCmd->SetGuidance("sequential: replay the original events in order (default)");
+    fModeCmd->SetGuidance("random: one randomly drawn record per event (resampling)");
+    fModeCmd->SetParameterName("mode", false);
+    fModeCmd->SetCandidates("sequential random");
+
+    fRandomPhiCmd = new G4UIcmdWithABool("/source/phasespace/randomPhi", this);
+    fRandomPhiCmd->SetGuidance("Rotate replayed particles about the z axis by a random angle");
+    fRandomPhiCmd->SetParameterName("flag", true);
+    fRandomPhiCmd->SetDefaultValue(true);
+
+    fFileDir = new G4UIdirectory("/source/file/");
+    fFileDir->SetGuidance("Pre-generated event input");
+
+    fEventFileCmd = new G4UIcmdWithAString("/source/file/name", this);
+    fEventFileCmd->SetGuidance("Event file to read; worker threads read disjoint event ranges");
+    fEventFileCmd->SetParameterName("FileName", false);
+
+    fFormatCmd = new G4UIcmdWithAString("/source/file/format", this);
+    fFormatCmd->SetGuidance("auto (default): detect from the file header");
+    fFormatCmd->SetGuidance("binary: phase-space records grouped by event number");
+    fFormatCmd->SetGuidance("hepmc3: HepMC3 ASCII, status-1 particles become primaries");
+    fFormatCmd->SetParameterName("format", false);
+    fFormatCmd->SetCandidates("auto binary hepmc3");
+
+    fConfineDir = new G4UIdirectory("/source/confine/");
+    fConfineDir->SetGuidance("Fast confinement of the GPS vertex positions to physical volumes");
+
+    fConfineVolumeCmd = new G4UIcmdWithAString("/source/confine/volume", this);
+    fConfineVolumeCmd->SetGuidance("Add a physical volume; vertices are uniform over all its placements");
+    fConfineVolumeCmd->SetGuidance("Points inside daughter volumes are excluded");
+    fConfineVolumeCmd->SetParameterName("PhysicalVolume", false);
+
+    fConfineClearCmd = new G4UIcmdWithoutParameter("/source/confine/clear", this);
+    fConfineClearCmd->SetGuidance("Remove all volumes (use the GPS positions again)");
+
+    fConfineSurfaceCmd = new G4UIcmdWithABool("/source/confine/surface", this);
+    fConfineSurfaceCmd->SetGuidance("Sample on the surface of the volumes instead of inside");
+    fConfineSurfaceCmd->SetParameterName("flag", true);
+    fConfineSurfaceCmd->SetDefaultValue(true);
+
+    fConfineCacheCmd = new G4UIcmdWithAnInteger("/source/confine/cache", this);
+    fConfineCacheCmd->SetGuidance("Number of points sampled once per run and reused by the events");
+    fConfineCacheCmd->SetGuidance("0 (default) samples a new point for every vertex");
+    fConfineCacheCmd->SetParameterName("N", false);
+    fConfineCacheCmd->SetRange("N>=0");
+  }
+  ~SourceMessenger() override {
+    delete fTypeCmd;
+    delete fFileCmd;
+    delete fModeCmd;
+    delete fRandomPhiCmd;
+    delete fEventFileCmd;
+    delete fFormatCmd;
+    delete fConfineVolumeCmd;
+    delete fConfineClearCmd;
+    delete fConfineSurfaceCmd;
+    delete fConfineCacheCmd;
+    delete fConfineDir;
+    delete fFileDir;
+    delete fPhaseSpaceDir;
+    delete fDir;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fTypeCmd)
+      PrimaryGeneratorAction::SetSourceType(val);
+    else if (cmd == fFileCmd)
+      PhaseSpaceSource::SetFileName(val);
+    else if (cmd == fModeCmd)
+      PhaseSpaceSource::SetRandom(val == "random");
+    else if (cmd == fRandomPhiCmd)
+      PhaseSpaceSource::SetRandomPhi(fRandomPhiCmd->GetNewBoolValue(val));
+    else if (cmd == fEventFileCmd)
+      EventFileSource::SetFileName(val);
+    else if (cmd == fFormatCmd)
+      EventFileSource::SetFormat(val);
+    else if (cmd == fConfineVolumeCmd)
+      ConfinementSampler::AddVolume(val);
+    else if (cmd == fConfineClearCmd)
+      ConfinementSampler::Clear();
+    else if (cmd == fConfineSurfaceCmd)
+      ConfinementSampler::SetSurface(fConfineSurfaceCmd->GetNewBoolValue(val));
+    else if (cmd == fConfineCacheCmd)
+      ConfinementSampler::SetCacheSize(fConfineCacheCmd->GetNewIntValue(val));
+  }
+private:
+  G4UIdirectory*      fDir;
+  G4UIcmdWithAString* fTypeCmd;
+  G4UIdirectory*      fPhaseSpaceDir;
+  G4UIcmdWithAString* fFileCmd;
+  G4UIcmdWithAString* fModeCmd;
+  G4UIcmdWithABool*   fRandomPhiCmd;
+  G4UIdirectory*      fFileDir;
+  G4UIcmdWithAString* fEventFileCmd;
+  G4UIcmdWithAString* fFormatCmd;
+  G4UIdirectory*      fConfineDir;
+  G4UIcmdWithAString* fConfineVolumeCmd;
+  G4UIcmdWithoutParameter* fConfineClearCmd;
+  G4UIcmdWithABool*   fConfineSurfaceCmd;
+  G4UIcmdWithAnInteger* fConfineCacheCmd;
+};
 
 /**
  * @brief Constructor – creates the GPS instance
@@ -21,9 +163,20 @@
  */
 PrimaryGeneratorAction::PrimaryGeneratorAction()
 : G4VUserPrimaryGeneratorAction(),
-  fGPS(new G4GeneralParticleSource())
+  fGPS(new G4GeneralParticleSource()),
+  fPhaseSpace(nullptr),
+  fEventFile(nullptr),
+  fConfinement(new ConfinementSampler())
 {
     // No hard-coded defaults – GPS is fully configured via macro commands.
+
+    // Create the source sweep once (shared by all instances)
+    if (!fSourceSweep) {
+        fSourceSweep = new SourceSweep();
+    }
+    if (!fMessenger) {
+        fMessenger = new SourceMessenger();
+    }
 }
 
 /**
@@ -32,13 +185,40 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
     delete fGPS;
+    delete fPhaseSpace;
+    delete fEventFile;
+    delete fConfinement;
 }
 
 /**
  * @brief Generates primary particles for each event
  * @param anEvent The current G4Event being processed
+ *
+ * Decay products deferred by the DecayWindow take precedence over the source,
+ * which is GPS, a phase-space file or an event file (/source/type).
+ * GPS vertices are moved into the /source/confine/ volumes if any are set.
  */
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+    if (DecayWindow::Instance()->GeneratePrimaries(anEvent)) return;
+
+    if (fSourceType == "phasespace") {
+        if (!fPhaseSpace) fPhaseSpace = new PhaseSpaceSource();
+        fPhaseSpace->GeneratePrimaries(anEvent);
+        return;
+    }
+    if (fSourceType == "file") {
+        if (!fEventFile) fEventFile = new EventFileSource();
+        fEventFile->GeneratePrimaries(anEvent);
+        return;
+    }
     fGPS->GeneratePrimaryVertex(anEvent);
+
+    if (ConfinementSampler::IsActive()) {
+        G4ThreeVector position;
+        for (G4int i = 0; i < anEvent->GetNumberOfPrimaryVertex(); i++) {
+            if (!fConfinement->Sample(position)) break;
+            anEvent->GetPrimaryVertex(i)->SetPosition(position.x(), position.y(), position.z());
+        }
+    }
 }
@@ -0,0 +1,212 @@
+/**
+ * @file ProgressMonitor.cc
+ * @brief Implementation of the ProgressMonitor class
+ */
+
+#include "ProgressMonitor.hh"
+#include "SimRunManager.hh"
+#include "json.hpp"
+
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UImessenger.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+G4Mutex progressMutex = G4MUTEX_INITIALIZER;
+}
+
+// ── Static members ──────────────────────────────────────
+G4String ProgressMonitor::fFileName = "";
+G4double ProgressMonitor::fInterval = 5.;
+G4int    ProgressMonitor::fRunID    = -1;
+G4int    ProgressMonitor::fNPlanned = 0;
+G4String ProgressMonitor::fOutputFile = "";
+G4long   ProgressMonitor::fNDone    = 0;
+G4long   ProgressMonitor::fNHits    = 0;
+std::map<G4int, G4long> ProgressMonitor::fThreadEvents;
+ProgressMonitor::Clock::time_point ProgressMonitor::fStart;
+ProgressMonitor::Clock::time_point ProgressMonitor::fLastWrite;
+G4long   ProgressMonitor::fNDoneLastWrite = 0;
+bool ProgressMonitor::fMessengerCreated = false;
+ProgressMonitor::ProgressMessenger* ProgressMonitor::fMessenger = nullptr;
+
+// ── Nested messenger for the /output/progress* commands ─
+class ProgressMonitor::ProgressMessenger : public G4UImessenger
+{
+public:
+  ProgressMessenger() {
+    // /output/ directory already exists (created by RunAction)
+    fFileCmd = new G4UIcmdWithAString("/output/progressFile", this);
+    fFileCmd->SetGuidance("JSON file with the live progress of the run (\"none\" = off)");
+    fFileCmd->SetGuidance("Rewritten atomically; with --processes every process writes <file>_p<i>");
+    fFileCmd->SetParameterName("FileName", false);
+
+    fIntervalCmd = new G4UIcmdWithADouble("/output/progressInterval", this);
+    fIntervalCmd->SetGuidance("Minimum time between two updates of the progress file in seconds (default 5)");
+    fIntervalCmd->SetParameterName("seconds", false);
+    fIntervalCmd->SetRange("seconds>=0");
+  }
+  ~ProgressMessenger() override {
+    delete fFileCmd;
+    delete fIntervalCmd;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fFileCmd)
+      ProgressMonitor::SetFileName(val);
+    else if (cmd == fIntervalCmd)
+      ProgressMonitor::SetInterval(fIntervalCmd->GetNewDoubleValue(val));
+  }
+private:
+  G4UIcmdWithAString* fFileCmd;
+  G4UIcmdWithADouble* fIntervalCmd;
+};
+
+/**
+ * @brief Create the /output/progress* commands (once)
+ */
+void ProgressMonitor::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new ProgressMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Reset the counters and write the initial status
+ * @param runID Run ID
+ * @param nPlanned Number of events to be processed
+ * @param outputFile ROOT file the run writes
+ */
+void ProgressMonitor::BeginOfRun(G4int runID, G4int nPlanned, const G4String& outputFile)
+{
+  if (fFileName.empty()) return;
+
+  G4AutoLock lock(&progressMutex);
+  fRunID = runID;
+  fNPlanned = nPlanned;
+  fOutputFile = outputFile;
+  fNDone = 0;
+  fNHits = 0;
+  fThreadEvents.clear();
+  fStart = Clock::now();
+  fLastWrite = fStart;
+  fNDoneLastWrite = 0;
+  Write("running");
+}
+
+/**
+ * @brief Count a finished event and rewrite the file if it is due
+ * @param nHits Number of hits of the event
+ */
+void ProgressMonitor::EndOfEvent(G4long nHits)
+{
+  if (fFileName.empty()) return;
+
+  G4AutoLock lock(&progressMutex);
+  fNDone++;
+  fNHits += nHits;
+  fThreadEvents[std::max(0, G4Threading::G4GetThreadId())]++;
+
+  if (std::chrono::duration<G4double>(Clock::now() - fLastWrite).count() >= fInterval) {
+    Write("running");
+  }
+}
+
+/**
+ * @brief Write the final status of the run
+ */
+void ProgressMonitor::EndOfRun()
+{
+  if (fFileName.empty()) return;
+
+  G4AutoLock lock(&progressMutex);
+  Write("finished");
+}
+
+/**
+ * @brief Write the status file (caller holds the lock)
+ * @param status "running" or "finished"
+ */
+void ProgressMonitor::Write(const std::string& status)
+{
+  const Clock::time_point now = Clock::now();
+  const G4double elapsed = std::chrono::duration<G4double>(now - fStart).count();
+  const G4double sinceLast = std::chrono::duration<G4double>(now - fLastWrite).count();
+
+  const G4double rate = (elapsed > 0) ? fNDone / elapsed : 0.;
+  nlohmann::json perThread = nlohmann::json::object();
+  for (const auto& [thread, events] : fThreadEvents) {
+    perThread[std::to_string(thread)] = (elapsed > 0) ? events / elapsed : 0.;
+  }
+
+  std::error_code error;
+  auto outputBytes = std::filesystem::file_size(std::string(fOutputFile), error);
+
+  nlohmann::json j;
+  j["status"] = status;
+  j["run"] = fRunID;
+  j["events_done"] = fNDone;
+  j["events_planned"] = fNPlanned;
+  j["elapsed_s"] = elapsed;
+  j["events_per_second"] = rate;
+  j["events_per_second_recent"] = (sinceLast > 0) ? (fNDone - fNDoneLastWrite) / sinceLast : 0.;
+  j["events_per_second_per_thread"] = perThread;
+  j["eta_s"] = (rate > 0) ? nlohmann::json(std::max<G4long>(0, fNPlanned - fNDone) / rate) : nlohmann::json();
+  j["rss_bytes"] = ResidentMemory();
+  j["hits_per_event"] = (fNDone > 0) ? G4double(fNHits) / fNDone : 0.;
+  j["output_file"] = std::string(fOutputFile);
+  j["output_bytes"] = error ? 0 : outputBytes;
+  j["pid"] = ::getpid();
+  j["updated"] = std::time(nullptr);
+
+  fLastWrite = now;
+  fNDoneLastWrite = fNDone;
+
+  // Write to a temporary file and rename it over the status file
+  const std::string fileName = SimRunManager::ShardFileName(fFileName);
+  const std::string tmpName = fileName + ".tmp";
+  {
+    std::ofstream out(tmpName, std::ios::trunc);
+    if (!out) {
+      G4cerr << "ProgressMonitor::Write() - Error: cannot write " << tmpName << G4endl;
+      return;
+    }
+    out << j.dump(2) << '\n';
+  }
+  if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    G4cerr << "ProgressMonitor::Write() - Error: cannot rename " << tmpName << " to " << fileName << G4endl;
+  }
+}
+
+/**
+ * @brief Resident set size of this process in bytes
+ * @return Current RSS from /proc (Linux), else the peak RSS, or 0 if unknown
+ */
+G4long ProgressMonitor::ResidentMemory()
+{
+  std::ifstream statm("/proc/self/statm");
+  G4long pages = 0, resident = 0;
+  if (statm >> pages >> resident) return resident * ::sysconf(_SC_PAGESIZE);
+
+  struct rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;           // bytes
+#else
+  return usage.ru_maxrss * 1024L;   // kilobytes
+#endif
+}
@@ -0,0 +1,45 @@
+/**
+ * @file RegionStepLimiter.cc
+ * @brief Implementation of the RegionStepLimiter class
+ */
+
+#include "RegionStepLimiter.hh"
+
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ios.hh"
+
+// ── Static members ──────────────────────────────────────
+G4bool RegionStepLimiter::fConstructed = false;
+G4bool RegionStepLimiter::fActive = false;
+
+/**
+ * @brief Attach the step limiter if the geometry has user limits
+ * @details Called at /run/initialize after the geometry was constructed, so the
+ *          regions of the geometry JSON exist by now.
+ */
+void RegionStepLimiter::ConstructProcess()
+{
+  fConstructed = true;
+  if (!GeometryHasUserLimits()) return;
+
+  G4StepLimiterPhysics::ConstructProcess();
+  fActive = true;
+  G4cout << "RegionStepLimiter::ConstructProcess() - Step limiter and user special cuts attached" << G4endl;
+}
+
+/**
+ * @brief True if any region or logical volume has user limits
+ */
+G4bool RegionStepLimiter::GeometryHasUserLimits()
+{
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    if (region->GetUserLimits()) return true;
+  }
+  for (const G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+    if (volume->GetUserLimits()) return true;
+  }
+  return false;
+}
@@ -7,6 +7,18 @@
  */
 
 #include "RunAction.hh"
+#include "KillPolicy.hh"
+#include "DecayWindow.hh"
+#include "PhaseSpaceWriter.hh"
+#include "ImportanceBiasing.hh"
+#include "SimRunManager.hh"
+#include "EventSeeder.hh"
+#include "ProgressMonitor.hh"
+#include "PhysicsTableCache.hh"
+#ifdef G4SIM_WITH_PROFILER
+#include "StepProfiler.hh"
+#endif
+#include "G4Threading.hh"
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
@@ -17,6 +29,10 @@
 
 #include "TFile.h"
 #include "TTree.h"
+#include "TList.h"
+#include "TNamed.h"
+
+std::map<std::string, std::string> RunAction::fMetadata;
 
 // ---------------------------------------------------------------------------
 //  Nested messenger class – mirrors the pattern in DetectorConstruction.cc
@@ -32,6 +48,8 @@ class RunAction::RunActionMessenger : public G4UImessenger
     RunAction*            fRunAction;
     G4UIdirectory*        fOutputDir;
     G4UIcmdWithAString*   fFileNameCmd;
+    G4UIcmdWithAString*   fTreeNameCmd;
+    G4UIcmdWithAString*   fFileModeCmd;
 };
 
 RunAction::RunActionMessenger::RunActionMessenger(RunAction* runAction)
@@ -43,11 +61,23 @@ RunAction::RunActionMessenger::RunActionMessenger(RunAction* runAction)
     fFileNameCmd = new G4UIcmdWithAString("/output/setFileName", this);
     fFileNameCmd->SetGuidance("Set the ROOT output file name (e.g. myrun.root)");
     fFileNameCmd->SetParameterName("FileName", false);
+
+    fTreeNameCmd = new G4UIcmdWithAString("/output/setTreeName", this);
+    fTreeNameCmd->SetGuidance("Set the name of the event tree (default: events)");
+    fTreeNameCmd->SetParameterName("TreeName", false);
+
+    fFileModeCmd = new G4UIcmdWithAString("/output/setFileMode", this);
+    fFileModeCmd->SetGuidance("recreate: overwrite the output file (default)");
+    fFileModeCmd->SetGuidance("update: add the tree of the next run to an existing file");
+    fFileModeCmd->SetParameterName("Mode", false);
+    fFileModeCmd->SetCandidates("recreate update");
 }
 
 RunAction::RunActionMessenger::~RunActionMessenger()
 {
     delete fFileNameCmd;
+    delete fTreeNameCmd;
+    delete fFileModeCmd;
     delete fOutputDir;
 }
 
@@ -56,6 +86,10 @@ void RunAction::RunActionMessenger::SetNewValue(G4UIcommand* command,
 {
     if (command == fFileNameCmd) {
         fRunAction->SetOutputFileName(newValue);
+    } else if (command == fTreeNameCmd) {
+        fRunAction->SetTreeName(newValue);
+    } else if (command == fFileModeCmd) {
+        fRunAction->SetFileMode(newValue == "update" ? "UPDATE" : "RECREATE");
     }
 }
 
@@ -67,9 +101,20 @@ RunAction::RunAction()
   fMessenger(nullptr),
   fRootFile(nullptr),
   fEventTree(nullptr),
-  fOutputFileName("G4sim.root")
+  fOutputFileName("G4sim.root"),
+  fTreeName("events"),
+  fFileMode("RECREATE")
 {
     fMessenger = new RunActionMessenger(this);
+    KillPolicy::CreateMessenger();
+    DecayWindow::CreateMessenger();
+    PhaseSpaceWriter::CreateMessenger();
+    EventSeeder::CreateMessenger();
+    ProgressMonitor::CreateMessenger();
+    PhysicsTableCache::CreateMessenger();
+#ifdef G4SIM_WITH_PROFILER
+    StepProfiler::CreateMessenger();
+#endif
 }
 
 RunAction::~RunAction()
@@ -84,7 +129,7 @@ RunAction::~RunAction()
     }
 }
 
-void RunAction::BeginOfRunAction(const G4Run*)
+void RunAction::BeginOfRunAction(const G4Run* run)
 {
     // Force long-lived isotopes (Na-22, Co-60, …) to decay within the event
     auto* ion = G4GenericIon::GenericIon();
@@ -103,19 +148,64 @@ void RunAction::BeginOfRunAction(const G4Run*)
       }
     }
 
-    // Create ROOT file and tree — branches are added by EventAction
-    G4cout << "RunAction: writing output to " << fOutputFileName << G4endl;
-    fRootFile = new TFile(fOutputFileName.c_str(), "RECREATE");
-    fEventTree = new TTree("events", "Geant4 Simulation Events");
+    if (IsMaster()) {
+        KillPolicy::BeginOfRun();
+        ImportanceBiasing::BeginOfRun();
+    }
+
+#ifdef G4SIM_WITH_PROFILER
+    if (StepProfiler::IsEnabled()) StepProfiler::Instance()->BeginOfRun(IsMaster());
+#endif
+
+    // Phase-space files are written by the threads that track particles
+    if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+        PhaseSpaceWriter::Instance()->BeginOfRun();
+    }
+
+    // Create ROOT file and tree — branches are added by EventAction.
+    // Forked processes write their own shard, merged by the parent process.
+    G4String fileName = SimRunManager::ShardFileName(fOutputFileName);
+    G4String fileMode = (SimRunManager::GetProcessIndex() >= 0) ? G4String("RECREATE") : fFileMode;
+    G4cout << "RunAction: writing tree " << fTreeName << " to " << fileName << G4endl;
+    fRootFile = new TFile(fileName.c_str(), fileMode.c_str());
+    fEventTree = new TTree(fTreeName.c_str(), "Geant4 Simulation Events");
+
+    if (IsMaster()) {
+        ProgressMonitor::BeginOfRun(run->GetRunID(), run->GetNumberOfEventToBeProcessed(), fileName);
+    }
 }
 
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
+    if (IsMaster()) KillPolicy::Report();
+
+#ifdef G4SIM_WITH_PROFILER
+    if (StepProfiler::IsEnabled()) {
+        StepProfiler::Instance()->EndOfRun();
+        if (IsMaster()) StepProfiler::Report();
+    }
+#endif
+
+    // Deferred decay products do not carry over into the next run
+    DecayWindow::Instance()->Clear();
+    PhaseSpaceWriter::Instance()->EndOfRun(run->GetNumberOfEvent());
+
     if (fRootFile) {
+        // Run metadata travels with the tree as TNamed objects in its user info
+        if (fEventTree) {
+            for (const auto& [key, value] : fMetadata) {
+                fEventTree->GetUserInfo()->Add(new TNamed(key.c_str(), value.c_str()));
+            }
+            for (const auto& [rule, count] : KillPolicy::Counters()) {
+                std::string key = "killed_" + rule;
+                fEventTree->GetUserInfo()->Add(new TNamed(key.c_str(), std::to_string(count).c_str()));
+            }
+        }
         fRootFile->Write();
         fRootFile->Close();
         delete fRootFile;
         fRootFile = nullptr;
         fEventTree = nullptr;  // owned by the TFile, now gone
     }
+    if (IsMaster()) ProgressMonitor::EndOfRun();
 }
@@ -0,0 +1,83 @@
+/**
+ * @file SensitiveDetectorFactory.cc
+ * @brief Implementation of the SensitiveDetectorFactory class
+ */
+
+#include "SensitiveDetectorFactory.hh"
+#include "MySensitiveDetector.hh"
+#include "VolumeScoringSD.hh"
+
+const G4String SensitiveDetectorFactory::DefaultType = "tracker";
+
+/**
+ * @brief The registry, with the built-in types on first use
+ * @return Creators by type name
+ */
+std::map<G4String, SensitiveDetectorFactory::Creator>& SensitiveDetectorFactory::Registry()
+{
+  static std::map<G4String, Creator> registry = {
+    {"tracker", [](const G4String& sdName, const G4String& collectionName) -> G4VSensitiveDetector* {
+       return new MySensitiveDetector(sdName, collectionName); }},
+    {"calorimeter", [](const G4String& sdName, const G4String& collectionName) -> G4VSensitiveDetector* {
+       return new CalorimeterSD(sdName, collectionName); }},
+    {"counter", [](const G4String& sdName, const G4String& collectionName) -> G4VSensitiveDetector* {
+       return new CounterSD(sdName, collectionName); }},
+    {"timing", [](const G4String& sdName, const G4String& collectionName) -> G4VSensitiveDetector* {
+       return new TimingSD(sdName, collectionName); }},
+  };
+  return registry;
+}
+
+/**
+ * @brief Add or replace a detector type
+ * @param type Type name used in the geometry JSON
+ * @param creator Function creating a detector of this type
+ */
+void SensitiveDetectorFactory::Register(const G4String& type, Creator creator)
+{
+  Registry()[type] = std::move(creator);
+}
+
+/**
+ * @brief Create a detector of a registered type
+ * @param type Type name
+ * @param sdName Name of the detector
+ * @param collectionName Name of its hits collection
+ * @return New detector, or nullptr if the type is unknown
+ */
+G4VSensitiveDetector* SensitiveDetectorFactory::Create(const G4String& type, const G4String& sdName,
+                                                       const G4String& collectionName)
+{
+  auto it = Registry().find(type);
+  return (it != Registry().end()) ? it->second(sdName, collectionName) : nullptr;
+}
+
+/**
+ * @brief True if the type is registered
+ * @param type Type name
+ */
+G4bool SensitiveDetectorFactory::IsKnown(const G4String& type)
+{
+  return Registry().count(type) > 0;
+}
+
+/**
+ * @brief Registered type names, sorted
+ */
+std::vector<G4String> SensitiveDetectorFactory::Types()
+{
+  std::vector<G4String> types;
+  for (const auto& [type, creator] : Registry()) types.push_back(type);
+  return types;
+}
+
+/**
+ * @brief Name of the detector of a collection and type
+ * @param collectionName Hits collection name
+ * @param type Type name
+ * @return <collection>_SD for the default type, <collection>_<type>_SD otherwise
+ */
+G4String SensitiveDetectorFactory::DetectorName(const G4String& collectionName, const G4String& type)
+{
+  return (type == DefaultType) ? collectionName + "_SD" : collectionName + "_" + type + "_SD";
+}
@@ -0,0 +1,208 @@
+/**
+ * @file SimRunManager.cc
+ * @brief Implementation of the SimRunManager class
+ */
+
+#include "SimRunManager.hh"
+#include "RunAction.hh"
+#include "EventSeeder.hh"
+#include "PhysicsTableCache.hh"
+#include "PhaseSpaceWriter.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "EventFileSource.hh"
+#include "SimulationServer.hh"
+
+#include "G4Run.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include "TFileMerger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ── Static members ──────────────────────────────────────
+G4int SimRunManager::fNProcesses = 0;
+G4int SimRunManager::fProcessIndex = -1;
+G4long SimRunManager::fProcessFirstEvent = 0;
+
+/**
+ * @brief Constructor implementation
+ */
+SimRunManager::SimRunManager()
+: G4RunManager()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+SimRunManager::~SimRunManager()
+{}
+
+/**
+ * @brief Per-process variant of an output file name
+ * @param name File name
+ * @param index Process index
+ * @return <stem>_p<index><ext>, or the name itself for index < 0
+ */
+G4String SimRunManager::ShardFileName(const G4String& name, G4int index)
+{
+  if (index < 0) return name;
+  std::filesystem::path path(std::string(name));
+  return (path.parent_path() / (path.stem().string() + "_p" + std::to_string(index) +
+                                path.extension().string())).string();
+}
+
+/**
+ * @brief Run n_event events, split over the child processes if requested
+ * @param n_event Number of events
+ * @param macroFile Macro executed for the first n_select events
+ * @param n_select Number of events the macro is executed for
+ * @details Children run their share of the events and exit; this process
+ *          waits for them, merges their output and carries on with the macro,
+ *          so the next BeamOn forks a fresh set of children.
+ */
+void SimRunManager::BeamOn(G4int n_event, const char* macroFile, G4int n_select)
+{
+  if (fProcessIndex < 0 && n_event > 0) n_event = EventSeeder::NumberOfEvents(n_event);
+
+  if (fNProcesses <= 1 || fProcessIndex >= 0 || n_event <= 0) {
+    G4RunManager::BeamOn(n_event, macroFile, n_select);
+    return;
+  }
+  if (!ConfirmBeamOnCondition()) return;
+
+  // Build the physics tables here so that the children inherit them
+  G4RunManager::BeamOn(0);
+
+  // Every child would otherwise produce an empty run without output
+  G4int nChildren = std::min(fNProcesses, n_event);
+
+  // Seeds come from this process's engine: reproducible, and different for
+  // every child and every run
+  std::vector<std::vector<long>> seeds(nChildren);
+  for (auto& seed : seeds) {
+    seed = {long(100000000L * G4UniformRand()), long(100000000L * G4UniformRand()), 0};
+  }
+
+  G4cout << "SimRunManager::BeamOn() - Running " << n_event << " event(s) in "
+         << nChildren << " processes" << G4endl;
+  std::cout.flush();
+  std::cerr.flush();
+
+  std::vector<pid_t> children;
+  for (G4int i = 0; i < nChildren; i++) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+      G4cerr << "SimRunManager::BeamOn() - Error: fork failed; " << (nChildren - i)
+             << " process(es) and their events are missing" << G4endl;
+      break;
+    }
+    if (pid == 0) {
+      fProcessIndex = i;
+      G4Random::setTheSeeds(seeds[i].data());
+      G4long first = G4long(n_event) * i / nChildren;
+      G4int nEvents = G4int(G4long(n_event) * (i + 1) / nChildren - first);
+      fProcessFirstEvent = first;
+      EventSeeder::SetFirstEvent(EventSeeder::GetFirstEvent() + first);
+      G4RunManager::BeamOn(nEvents, macroFile, n_select);
+      std::cout.flush();
+      std::cerr.flush();
+      std::quick_exit(runAborted ? 1 : 0);
+    }
+    children.push_back(pid);
+  }
+
+  G4bool ok = !children.empty();
+  for (size_t i = 0; i < children.size(); i++) {
+    int status = 0;
+    ::waitpid(children[i], &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      G4cerr << "SimRunManager::BeamOn() - Error: process " << i << " failed" << G4endl;
+      ok = false;
+    }
+  }
+
+  // The children used this run ID; the next run gets a new one
+  runIDCounter++;
+  // and wrote their phase-space shards, which the next run appends to
+  PhaseSpaceWriter::MarkWritten();
+  // and read the run's events of an input file, which the next run continues after
+  if (PrimaryGeneratorAction::GetSourceType() == "file") EventFileSource::AdvanceForkedRun(n_event);
+
+  if (ok) {
+    MergeOutput(G4int(children.size()));
+  } else {
+    G4cerr << "SimRunManager::BeamOn() - Output shards are kept for inspection" << G4endl;
+  }
+}
+
+/**
+ * @brief Initialise the run, using the physics table cache for the first one
+ * @details The physics tables are built (or retrieved) here, in the parent
+ *          process when running with child processes.
+ */
+void SimRunManager::RunInitialization()
+{
+  PhysicsTableCache::BeforeBuild(physicsList);
+  const auto start = std::chrono::steady_clock::now();
+  G4RunManager::RunInitialization();
+  PhysicsTableCache::AfterBuild(physicsList,
+      std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Create the next event, reseeding the engine for it first
+ * @param i_event Event ID within the run
+ * @return New event with its primaries
+ */
+G4Event* SimRunManager::GenerateEvent(G4int i_event)
+{
+  const G4int runID = currentRun ? currentRun->GetRunID() : runIDCounter;
+  SimulationServer::Poll(runID, i_event, numberOfEventToBeProcessed);
+  EventSeeder::SeedEvent(runID, i_event);
+  return G4RunManager::GenerateEvent(i_event);
+}
+
+/**
+ * @brief Merge the ROOT output shards of the children into the output file
+ * @param nShards Number of shards
+ * @details The output file is recreated or, in update mode, the merged tree
+ *          is added to it.  The tree user info is taken from the first shard.
+ */
+void SimRunManager::MergeOutput(G4int nShards) const
+{
+  const auto* runAction = dynamic_cast<const RunAction*>(GetUserRunAction());
+  if (!runAction) return;
+
+  const G4String output = runAction->GetOutputFileName();
+  const G4bool update = (runAction->GetFileMode() == "UPDATE");
+
+  TFileMerger merger(false);
+  merger.SetPrintLevel(0);
+  merger.OutputFile(output.c_str(), update ? "UPDATE" : "RECREATE");
+  for (G4int i = 0; i < nShards; i++) {
+    merger.AddFile(ShardFileName(output, i).c_str(), false);
+  }
+  G4bool merged = update ? merger.PartialMerge(TFileMerger::kAll | TFileMerger::kIncremental)
+                         : merger.Merge();
+  if (!merged) {
+    G4cerr << "SimRunManager::MergeOutput() - Error: merging into " << output
+           << " failed; the shards are kept" << G4endl;
+    return;
+  }
+
+  for (G4int i = 0; i < nShards; i++) {
+    std::remove(ShardFileName(output, i).c_str());
+  }
+  G4cout << "SimRunManager::MergeOutput() - " << nShards << " shard(s) merged into " << output << G4endl;
+}
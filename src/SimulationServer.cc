@@ -0,0 +1,347 @@
+/**
+ * @file SimulationServer.cc
+ * @brief Implementation of the SimulationServer class
+ */
+
+#include "SimulationServer.hh"
+#include "RunAction.hh"
+#include "DetectorConstruction.hh"
+#include "json.hpp"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4coutDestination.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+/// Set by SIGINT / SIGTERM: end the current run and shut down
+volatile std::sig_atomic_t stopRequested = 0;
+
+void RequestStop(int) { stopRequested = 1; }
+
+/// Commands of a reset request: the run settings that a fresh G4sim starts
+/// with, for everything a macro sets up cumulatively (keep in sync with the
+/// class documentation)
+const char* const kResetCommands[] = {
+  "/gps/source/clear",
+  "/gps/source/add 1",
+  "/gps/source/multiplevertex false",
+  "/gps/source/flatsampling false",
+  "/source/type gps",
+  "/source/confine/clear",
+  "/source/confine/surface false",
+  "/source/confine/cache 0",
+  "/source/phasespace/file phasespace.bin",
+  "/source/phasespace/mode sequential",
+  "/source/phasespace/randomPhi false",
+  "/source/file/format auto",
+  "/kill/reset",
+  "/decay/setTimeWindow 0",
+  "/sweep/source/clear",
+  "/detector/sweep/clear",
+  "/random/setMasterSeed 0",
+  "/random/setFirstEvent 0",
+  "/phasespace/setFileName phasespace.bin",
+  "/output/setTreeName events",
+  "/output/setFileMode recreate",
+  "/output/setSummarize 0",
+  "/hits/setVerbose 0",
+};
+
+/// Seconds since a time point
+G4double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// ── Static members ──────────────────────────────────────
+G4int       SimulationServer::fClient        = -1;
+std::string SimulationServer::fInput;
+G4bool      SimulationServer::fBusy          = false;
+G4bool      SimulationServer::fShutdown      = false;
+G4long      SimulationServer::fNRequests     = 0;
+std::string SimulationServer::fEngineState;
+G4int       SimulationServer::fRunID         = -1;
+G4int       SimulationServer::fEventsStarted = 0;
+G4int       SimulationServer::fEventsPlanned = 0;
+SimulationServer::Clock::time_point SimulationServer::fStarted;
+SimulationServer::Clock::time_point SimulationServer::fRunStart;
+SimulationServer::Clock::time_point SimulationServer::fLastProgress;
+
+// ── Output of a request, echoed and streamed to the client ─
+class SimulationServer::StreamDestination : public G4coutDestination
+{
+public:
+  G4int ReceiveG4cout(const G4String& msg) override {
+    std::cout << msg << std::flush;
+    Forward("out", msg);
+    return 0;
+  }
+  G4int ReceiveG4cerr(const G4String& msg) override {
+    std::cerr << msg << std::flush;
+    Forward("err", msg);
+    return 0;
+  }
+private:
+  static void Forward(const char* stream, const G4String& msg) {
+    std::string text(msg);
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+    nlohmann::json line = {{"type", "log"}, {"stream", stream}, {"text", text}};
+    SimulationServer::Send(line.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+  }
+};
+
+/**
+ * @brief Serve requests on a socket until shutdown
+ * @param socketPath Path of the Unix domain socket (replaced if it exists)
+ * @return Exit code of the program
+ */
+G4int SimulationServer::Serve(const G4String& socketPath)
+{
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    G4cerr << "SimulationServer::Serve() - Error: socket path too long: " << socketPath << G4endl;
+    return 1;
+  }
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::unlink(socketPath.c_str());
+  if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+      ::listen(listener, 1) < 0) {
+    G4cerr << "SimulationServer::Serve() - Error: cannot listen on " << socketPath << ": "
+           << std::strerror(errno) << G4endl;
+    if (listener >= 0) ::close(listener);
+    return 1;
+  }
+  // Commands run with the rights of this process: owner only
+  ::chmod(socketPath.c_str(), S_IRUSR | S_IWUSR);
+
+  // A client going away must not kill the server; a stop signal ends the
+  // current run and the server (no SA_RESTART, so accept() is interrupted)
+  std::signal(SIGPIPE, SIG_IGN);
+  struct sigaction stop{};
+  stop.sa_handler = RequestStop;
+  ::sigaction(SIGINT, &stop, nullptr);
+  ::sigaction(SIGTERM, &stop, nullptr);
+
+  std::ostringstream engineState;
+  G4Random::saveFullState(engineState);
+  fEngineState = engineState.str();
+
+  fStarted = Clock::now();
+  G4cout << "SimulationServer - Listening on " << socketPath << G4endl;
+
+  while (!fShutdown && !stopRequested) {
+    const int client = ::accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR) continue;
+      G4cerr << "SimulationServer::Serve() - Error: accept failed: " << std::strerror(errno) << G4endl;
+      break;
+    }
+    fClient = client;
+    fInput.clear();
+    Send(nlohmann::json({{"type", "ready"}, {"pid", ::getpid()}}).dump());
+
+    while (fClient >= 0 && !fShutdown && !stopRequested) {
+      const size_t end = fInput.find('\n');
+      if (end == std::string::npos) {
+        if (!Receive(true)) break;
+        continue;
+      }
+      const std::string request = fInput.substr(0, end);
+      fInput.erase(0, end + 1);
+      Handle(request);
+    }
+    if (fClient >= 0) ::close(fClient);
+    fClient = -1;
+  }
+
+  ::close(listener);
+  ::unlink(socketPath.c_str());
+  G4cout << "SimulationServer - Shut down after " << fNRequests << " request(s)" << G4endl;
+  return 0;
+}
+
+/**
+ * @brief Handle one request line from the client
+ * @param line Request without its newline
+ */
+void SimulationServer::Handle(const std::string& line)
+{
+  const size_t first = line.find_first_not_of(" \t\r");
+  if (first == std::string::npos || line[first] == '#') return;
+  const std::string request = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+  fNRequests++;
+
+  nlohmann::json done = {{"type", "done"}, {"request", request}};
+  if (request == "status") {
+    done["ok"] = true;
+    done["state"] = fBusy ? "busy" : "idle";
+    done["pid"] = ::getpid();
+    done["uptime_s"] = SecondsSince(fStarted);
+    done["requests"] = fNRequests;
+    done["run"] = fRunID;
+    done["events_done"] = fBusy ? std::max(fEventsStarted - 1, 0) : fEventsStarted;
+    done["events_planned"] = fEventsPlanned;
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+    if (const auto* runAction = dynamic_cast<const RunAction*>(runManager->GetUserRunAction())) {
+      done["output_file"] = std::string(runAction->GetOutputFileName());
+    }
+    if (const auto* detector =
+            dynamic_cast<const DetectorConstruction*>(runManager->GetUserDetectorConstruction())) {
+      done["geometry_file"] = std::string(detector->GetGeometryFile());
+    }
+  } else if (request == "abort") {
+    done["ok"] = fBusy;
+    if (fBusy) {
+      G4RunManager::GetRunManager()->AbortRun(true);
+    } else {
+      done["error"] = "no run in progress";
+    }
+  } else if (request == "shutdown") {
+    done["ok"] = true;
+    fShutdown = true;
+    if (fBusy) G4RunManager::GetRunManager()->AbortRun(true);
+  } else if (request == "reset") {
+    if (fBusy) {
+      done["ok"] = false;
+      done["error"] = "busy: a run is in progress";
+    } else {
+      StreamDestination destination;
+      G4iosSetDestination(&destination);
+      std::vector<std::string> failed;
+      for (const char* command : kResetCommands) {
+        if (G4UImanager::GetUIpointer()->ApplyCommand(command) != 0) failed.push_back(command);
+      }
+      G4iosSetDestination(nullptr);
+      std::istringstream engineState(fEngineState);
+      G4Random::restoreFullState(engineState);
+      done["ok"] = failed.empty();
+      if (!failed.empty()) done["failed"] = failed;
+    }
+  } else if (request[0] != '/') {
+    done["ok"] = false;
+    done["error"] = "unknown request (expected a UI command, status, abort, reset or shutdown)";
+  } else if (fBusy) {
+    done["ok"] = false;
+    done["error"] = "busy: a run is in progress";
+  } else {
+    const G4int runBefore = fRunID;
+    const auto start = Clock::now();
+    StreamDestination destination;
+    G4iosSetDestination(&destination);
+    fBusy = true;
+    const G4int code = G4UImanager::GetUIpointer()->ApplyCommand(request);
+    fBusy = false;
+    G4iosSetDestination(nullptr);
+
+    done["ok"] = (code == 0);
+    done["code"] = code;
+    done["elapsed_s"] = SecondsSince(start);
+    if (fRunID != runBefore) {
+      done["run"] = fRunID;
+      done["events_done"] = fEventsStarted;
+      done["events_planned"] = fEventsPlanned;
+    }
+  }
+  Send(done.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+}
+
+/**
+ * @brief Answer status and abort requests and report progress during a run
+ * @param runID Current run
+ * @param iEvent Event about to be generated
+ * @param nPlanned Events of the run
+ */
+void SimulationServer::PollClient(G4int runID, G4int iEvent, G4int nPlanned)
+{
+  const auto now = Clock::now();
+  if (runID != fRunID || iEvent == 0) {
+    fRunID = runID;
+    fEventsPlanned = nPlanned;
+    fRunStart = now;
+    fLastProgress = now;
+  }
+  fEventsStarted = iEvent + 1;
+
+  if (stopRequested) {
+    fShutdown = true;
+    G4RunManager::GetRunManager()->AbortRun(true);
+  }
+
+  if (std::chrono::duration<G4double>(now - fLastProgress).count() >= 0.5) {
+    fLastProgress = now;
+    const G4double elapsed = std::chrono::duration<G4double>(now - fRunStart).count();
+    nlohmann::json progress = {
+      {"type", "progress"}, {"run", runID}, {"events_done", iEvent},
+      {"events_planned", nPlanned}, {"elapsed_s", elapsed},
+      {"events_per_second", elapsed > 0 ? iEvent / elapsed : 0.}};
+    Send(progress.dump());
+  }
+
+  // Only status, abort and shutdown can be served now; the rest is refused
+  if (!Receive(false)) return;
+  for (size_t end; fClient >= 0 && (end = fInput.find('\n')) != std::string::npos;) {
+    const std::string request = fInput.substr(0, end);
+    fInput.erase(0, end + 1);
+    Handle(request);
+  }
+}
+
+/**
+ * @brief Read what the client sent into the input buffer
+ * @param wait Block until data arrives
+ * @return false if the client has gone (its socket is then closed)
+ */
+G4bool SimulationServer::Receive(G4bool wait)
+{
+  char buffer[4096];
+  const ssize_t n = ::recv(fClient, buffer, sizeof(buffer), wait ? 0 : MSG_DONTWAIT);
+  if (n > 0) {
+    fInput.append(buffer, size_t(n));
+    return true;
+  }
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return true;
+
+  // The run of a client that has gone carries on; its output is still written
+  ::close(fClient);
+  fClient = -1;
+  return false;
+}
+
+/**
+ * @brief Send a JSON line to the client
+ * @param line JSON text without newline
+ * @details Dropped if the client has gone.
+ */
+void SimulationServer::Send(const std::string& line)
+{
+  if (fClient < 0) return;
+  const std::string data = line + '\n';
+  size_t sent = 0;
+  while (sent < data.size()) {
+    const ssize_t n = ::send(fClient, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return;
+    sent += size_t(n);
+  }
+}
@@ -0,0 +1,307 @@
+/**
+ * @file SourceSweep.cc
+ * @brief Implementation of the SourceSweep class
+ */
+
+#include "SourceSweep.hh"
+#include "RunAction.hh"
+#include "PhaseSpaceWriter.hh"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UImessenger.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcommandStatus.hh"
+
+#include <cmath>
+#include <sstream>
+
+/**
+ * @brief Nested messenger class for SourceSweep
+ *
+ * Handles the /sweep/source/ commands
+ */
+class SourceSweep::SweepMessenger : public G4UImessenger
+{
+  public:
+    SweepMessenger(SourceSweep* sweep);
+    virtual ~SweepMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    SourceSweep* fSweep;
+
+    G4UIdirectory*        fSweepDir;
+    G4UIdirectory*        fSourceDir;
+    G4UIcommand*          fAddAxisCmd;
+    G4UIcommand*          fAddRangeCmd;
+    G4UIcommand*          fListCmd;
+    G4UIcommand*          fClearCmd;
+    G4UIcmdWithAnInteger* fRunCmd;
+};
+
+/**
+ * @brief Constructor for the SweepMessenger
+ * @param sweep Pointer to the associated SourceSweep
+ */
+SourceSweep::SweepMessenger::SweepMessenger(SourceSweep* sweep)
+: fSweep(sweep)
+{
+    fSweepDir = new G4UIdirectory("/sweep/");
+    fSweepDir->SetGuidance("Parameter sweeps in one initialised run manager");
+
+    fSourceDir = new G4UIdirectory("/sweep/source/");
+    fSourceDir->SetGuidance("Sweep a grid of source (/gps/) settings, one tree per grid point");
+
+    fAddAxisCmd = new G4UIcommand("/sweep/source/addAxis", this);
+    fAddAxisCmd->SetGuidance("Add an axis: a UI command and a comma-separated list of its parameters");
+    fAddAxisCmd->SetGuidance("e.g. /sweep/source/addAxis /gps/particle gamma,neutron");
+    fAddAxisCmd->SetGuidance("     /sweep/source/addAxis /gps/pos/centre 0 0 -10 cm, 0 0 10 cm");
+    fAddAxisCmd->SetParameter(new G4UIparameter("command", 's', false));
+    fAddAxisCmd->SetParameter(new G4UIparameter("values", 's', false));
+
+    fAddRangeCmd = new G4UIcommand("/sweep/source/addRange", this);
+    fAddRangeCmd->SetGuidance("Add an axis of n evenly spaced values from min to max");
+    fAddRangeCmd->SetGuidance("e.g. /sweep/source/addRange /gps/ene/mono 10 3000 50 keV log");
+    fAddRangeCmd->SetParameter(new G4UIparameter("command", 's', false));
+    fAddRangeCmd->SetParameter(new G4UIparameter("min", 'd', false));
+    fAddRangeCmd->SetParameter(new G4UIparameter("max", 'd', false));
+    auto* nParam = new G4UIparameter("n", 'i', false);
+    nParam->SetParameterRange("n>=1");
+    fAddRangeCmd->SetParameter(nParam);
+    auto* unitParam = new G4UIparameter("unit", 's', true);
+    unitParam->SetDefaultValue("none");
+    fAddRangeCmd->SetParameter(unitParam);
+    auto* scaleParam = new G4UIparameter("scale", 's', true);
+    scaleParam->SetDefaultValue("lin");
+    scaleParam->SetParameterCandidates("lin log");
+    fAddRangeCmd->SetParameter(scaleParam);
+
+    fListCmd = new G4UIcommand("/sweep/source/list", this);
+    fListCmd->SetGuidance("Print the axes and the number of grid points");
+
+    fClearCmd = new G4UIcommand("/sweep/source/clear", this);
+    fClearCmd->SetGuidance("Remove all axes");
+
+    fRunCmd = new G4UIcmdWithAnInteger("/sweep/source/run", this);
+    fRunCmd->SetGuidance("Run N events for every grid point, each into its own tree");
+    fRunCmd->SetParameterName("nEvents", false);
+    fRunCmd->SetRange("nEvents>=0");
+    fRunCmd->AvailableForStates(G4State_Idle);
+}
+
+/**
+ * @brief Destructor for the SweepMessenger
+ */
+SourceSweep::SweepMessenger::~SweepMessenger()
+{
+    delete fAddAxisCmd;
+    delete fAddRangeCmd;
+    delete fListCmd;
+    delete fClearCmd;
+    delete fRunCmd;
+    delete fSourceDir;
+    delete fSweepDir;
+}
+
+/**
+ * @brief Handle UI commands
+ * @param command The command being executed
+ * @param newValue The new value for the command parameter
+ */
+void SourceSweep::SweepMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    std::istringstream is(newValue);
+    if (command == fAddAxisCmd) {
+        std::string uiCommand, rest, value;
+        is >> uiCommand;
+        std::getline(is, rest);
+        std::vector<std::string> values;
+        std::istringstream list(rest);
+        while (std::getline(list, value, ',')) {
+            size_t first = value.find_first_not_of(" \t\"");
+            size_t last = value.find_last_not_of(" \t\"");
+            if (first != std::string::npos) {
+                values.push_back(value.substr(first, last - first + 1));
+            }
+        }
+        fSweep->AddAxis(uiCommand, values);
+    } else if (command == fAddRangeCmd) {
+        std::string uiCommand, unit, scale;
+        G4double min = 0, max = 0;
+        G4int n = 0;
+        is >> uiCommand >> min >> max >> n >> unit >> scale;
+        fSweep->AddRange(uiCommand, min, max, n, unit == "none" ? "" : unit, scale == "log");
+    } else if (command == fListCmd) {
+        fSweep->List();
+    } else if (command == fClearCmd) {
+        fSweep->Clear();
+    } else if (command == fRunCmd) {
+        fSweep->Run(fRunCmd->GetNewIntValue(newValue));
+    }
+}
+
+/**
+ * @brief Constructor implementation
+ */
+SourceSweep::SourceSweep()
+: fMessenger(nullptr)
+{
+    fMessenger = new SweepMessenger(this);
+}
+
+/**
+ * @brief Destructor implementation
+ */
+SourceSweep::~SourceSweep()
+{
+    delete fMessenger;
+}
+
+/**
+ * @brief Add an axis with explicit values
+ * @param command UI command to apply
+ * @param values Parameter strings of the command
+ */
+void SourceSweep::AddAxis(const std::string& command, const std::vector<std::string>& values)
+{
+    if (values.empty()) {
+        G4cerr << "SourceSweep::AddAxis() - Error: no values given for " << command << G4endl;
+        return;
+    }
+    fAxes.push_back({command, values});
+    G4cout << "SourceSweep::AddAxis() - " << command << " with " << values.size() << " values" << G4endl;
+}
+
+/**
+ * @brief Add an axis with evenly spaced numeric values
+ * @param command UI command to apply
+ * @param min First value
+ * @param max Last value
+ * @param n Number of values
+ * @param unit Unit appended to every value (may be empty)
+ * @param logarithmic Space the values logarithmically instead of linearly
+ */
+void SourceSweep::AddRange(const std::string& command, G4double min, G4double max, G4int n,
+                           const std::string& unit, G4bool logarithmic)
+{
+    if (logarithmic && (min <= 0 || max <= 0)) {
+        G4cerr << "SourceSweep::AddRange() - Error: logarithmic range needs positive limits" << G4endl;
+        return;
+    }
+
+    std::vector<std::string> values;
+    for (G4int i = 0; i < n; i++) {
+        G4double f = (n > 1) ? G4double(i) / (n - 1) : 0.;
+        G4double value = logarithmic ? min * std::pow(max / min, f) : min + f * (max - min);
+        std::ostringstream os;
+        os.precision(10);
+        os << value;
+        if (!unit.empty()) os << " " << unit;
+        values.push_back(os.str());
+    }
+    AddAxis(command, values);
+}
+
+/**
+ * @brief Number of grid points (product of the axis lengths)
+ * @return Number of grid points, 0 without axes
+ */
+size_t SourceSweep::NumberOfPoints() const
+{
+    if (fAxes.empty()) return 0;
+    size_t n = 1;
+    for (const auto& axis : fAxes) {
+        n *= axis.values.size();
+    }
+    return n;
+}
+
+/**
+ * @brief Print the axes and the number of grid points
+ */
+void SourceSweep::List() const
+{
+    G4cout << "SourceSweep - " << fAxes.size() << " axis/axes, " << NumberOfPoints() << " grid point(s):" << G4endl;
+    for (const auto& axis : fAxes) {
+        G4cout << "  " << axis.command << ":";
+        for (const auto& value : axis.values) {
+            G4cout << " [" << value << "]";
+        }
+        G4cout << G4endl;
+    }
+}
+
+/**
+ * @brief Run every grid point
+ * @param nEvents Number of events per grid point
+ * @details Grid points are numbered with the last axis varying fastest.  Point i is
+ *          written to tree <tree>_<i> of the current output file; the first point
+ *          recreates the file, later points are added to it.  Each tree carries the
+ *          command/value pairs of its point and "sweep_point" in its user info.
+ *          The output settings are restored afterwards; the source keeps the settings
+ *          of the last point.
+ */
+void SourceSweep::Run(G4int nEvents)
+{
+    size_t nPoints = NumberOfPoints();
+    if (nPoints == 0) {
+        G4cout << "SourceSweep::Run() - No axes defined" << G4endl;
+        return;
+    }
+
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+    auto* runAction = static_cast<const RunAction*>(runManager->GetUserRunAction());
+    if (!runAction) {
+        G4cerr << "SourceSweep::Run() - Error: no RunAction, call /run/initialize first" << G4endl;
+        return;
+    }
+    std::string treeName = runAction->GetTreeName();
+    G4UImanager* uiManager = G4UImanager::GetUIpointer();
+
+    const G4String basePhaseSpace = PhaseSpaceWriter::GetFileName();
+    for (size_t point = 0; point < nPoints; point++) {
+        G4cout << "SourceSweep::Run() - Grid point " << (point + 1) << "/" << nPoints << G4endl;
+
+        // Decode the point index, last axis fastest
+        std::vector<size_t> steps(fAxes.size());
+        size_t rest = point;
+        for (size_t a = fAxes.size(); a-- > 0;) {
+            steps[a] = rest % fAxes[a].values.size();
+            rest /= fAxes[a].values.size();
+        }
+
+        G4bool ok = true;
+        for (size_t a = 0; a < fAxes.size() && ok; a++) {
+            const std::string& value = fAxes[a].values[steps[a]];
+            G4int status = uiManager->ApplyCommand(fAxes[a].command + " " + value);
+            if (status != fCommandSucceeded) {
+                G4cerr << "SourceSweep::Run() - Error: \"" << fAxes[a].command << " " << value
+                       << "\" failed with status " << status << "; sweep aborted" << G4endl;
+                ok = false;
+            }
+            RunAction::SetMetadata(fAxes[a].command, value);
+        }
+        if (!ok) break;
+
+        RunAction::SetMetadata("sweep_point", std::to_string(point));
+        uiManager->ApplyCommand("/output/setTreeName " + treeName + "_" + std::to_string(point));
+        uiManager->ApplyCommand(std::string("/output/setFileMode ") + (point == 0 ? "recreate" : "update"));
+        PhaseSpaceWriter::SetFileName(PhaseSpaceWriter::FileNameWithSuffix(basePhaseSpace, std::to_string(point)));
+
+        runManager->BeamOn(nEvents);
+    }
+
+    // Restore the output settings
+    for (const auto& axis : fAxes) {
+        RunAction::RemoveMetadata(axis.command);
+    }
+    RunAction::RemoveMetadata("sweep_point");
+    uiManager->ApplyCommand("/output/setTreeName " + treeName);
+    uiManager->ApplyCommand("/output/setFileMode recreate");
+    PhaseSpaceWriter::SetFileName(basePhaseSpace, false);
+}
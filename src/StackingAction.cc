@@ -0,0 +1,44 @@
+/**
+ * @file StackingAction.cc
+ * @brief Implementation of the StackingAction class
+ */
+
+#include "StackingAction.hh"
+#include "KillPolicy.hh"
+#include "DecayWindow.hh"
+
+#include "G4Track.hh"
+
+/**
+ * @brief Constructor implementation
+ */
+StackingAction::StackingAction()
+: G4UserStackingAction()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+StackingAction::~StackingAction()
+{}
+
+/**
+ * @brief Classify a new track
+ * @param track Track about to be stacked
+ * @return fKill if the track is deferred to a later event or a KillPolicy rule
+ *         applies, fUrgent otherwise
+ */
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+    // Late decay products go to a later event; checked before the kill time window
+    if (DecayWindow::IsEnabled() && DecayWindow::Instance()->Defer(track)) {
+        return fKill;
+    }
+
+    G4int rule = KillPolicy::CheckNewTrack(track);
+    if (rule >= 0) {
+        KillPolicy::Count(rule);
+        return fKill;
+    }
+    return fUrgent;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file StepProfiler.cc
+ * @brief Implementation of the StepProfiler class
+ */
+
+#include "StepProfiler.hh"
+#include "SimRunManager.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UImessenger.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+G4Mutex profileMutex = G4MUTEX_INITIALIZER;
+}
+
+// ── Static members ──────────────────────────────────────
+G4ThreadLocal StepProfiler* StepProfiler::fInstance = nullptr;
+std::map<StepProfiler::NameKey, StepProfiler::Entry> StepProfiler::fMerged;
+G4bool   StepProfiler::fEnabled  = false;
+G4int    StepProfiler::fTop      = 20;
+G4String StepProfiler::fFileName = "";
+bool StepProfiler::fMessengerCreated = false;
+StepProfiler::ProfileMessenger* StepProfiler::fMessenger = nullptr;
+
+// ── Nested messenger for the /profile/ commands ─────────
+class StepProfiler::ProfileMessenger : public G4UImessenger
+{
+public:
+  ProfileMessenger() {
+    fDir = new G4UIdirectory("/profile/");
+    fDir->SetGuidance("Stepping profiler: CPU time per volume, particle and process");
+
+    fEnableCmd = new G4UIcmdWithABool("/profile/enable", this);
+    fEnableCmd->SetGuidance("Profile the following runs");
+    fEnableCmd->SetParameterName("flag", true);
+    fEnableCmd->SetDefaultValue(true);
+
+    fTopCmd = new G4UIcmdWithAnInteger("/profile/top", this);
+    fTopCmd->SetGuidance("Number of rows printed at the end of the run (default 20)");
+    fTopCmd->SetParameterName("N", false);
+    fTopCmd->SetRange("N>=0");
+
+    fFileCmd = new G4UIcmdWithAString("/profile/setFileName", this);
+    fFileCmd->SetGuidance("Write the full table as CSV to this file (\"none\" = off)");
+    fFileCmd->SetParameterName("FileName", false);
+  }
+  ~ProfileMessenger() override {
+    delete fEnableCmd;
+    delete fTopCmd;
+    delete fFileCmd;
+    delete fDir;
+  }
+
+  void SetNewValue(G4UIcommand* cmd, G4String val) override {
+    if (cmd == fEnableCmd)
+      StepProfiler::SetEnabled(fEnableCmd->GetNewBoolValue(val));
+    else if (cmd == fTopCmd)
+      StepProfiler::SetTop(fTopCmd->GetNewIntValue(val));
+    else if (cmd == fFileCmd)
+      StepProfiler::SetFileName(val);
+  }
+private:
+  G4UIdirectory*        fDir;
+  G4UIcmdWithABool*     fEnableCmd;
+  G4UIcmdWithAnInteger* fTopCmd;
+  G4UIcmdWithAString*   fFileCmd;
+};
+
+/**
+ * @brief Thread-local instance
+ * @return The profiler of the calling thread
+ */
+StepProfiler* StepProfiler::Instance()
+{
+  if (!fInstance) fInstance = new StepProfiler();
+  return fInstance;
+}
+
+/**
+ * @brief Create the /profile/ messenger (once)
+ */
+void StepProfiler::CreateMessenger()
+{
+  if (!fMessengerCreated) {
+    fMessenger = new ProfileMessenger();
+    fMessengerCreated = true;
+  }
+}
+
+/**
+ * @brief Hash of a key
+ * @param key Table key
+ * @return Combined hash of the three pointers
+ */
+std::size_t StepProfiler::KeyHash::operator()(const Key& key) const
+{
+  std::hash<const void*> hash;
+  std::size_t h = hash(key.volume);
+  h ^= hash(key.particle) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  h ^= hash(key.process) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  return h;
+}
+
+/**
+ * @brief Charge the time since the last step to this step
+ * @param step Step just taken
+ */
+void StepProfiler::Step(const G4Step* step)
+{
+  const Clock::time_point now = Clock::now();
+  const G4double seconds = std::chrono::duration<G4double>(now - fLast).count();
+  fLast = now;
+
+  const G4VPhysicalVolume* volume = step->GetPreStepPoint()->GetPhysicalVolume();
+  Key key{volume ? volume->GetLogicalVolume() : nullptr,
+          step->GetTrack()->GetParticleDefinition(),
+          step->GetPostStepPoint()->GetProcessDefinedStep()};
+  Entry& entry = fTable[key];
+  entry.steps++;
+  entry.seconds += seconds;
+}
+
+/**
+ * @brief Clear this thread's table (and, on the master, the merged one)
+ * @param master True for the master (or sequential) run action
+ */
+void StepProfiler::BeginOfRun(G4bool master)
+{
+  fTable.clear();
+  fLast = Clock::now();
+  if (master) {
+    G4AutoLock lock(&profileMutex);
+    fMerged.clear();
+  }
+}
+
+/**
+ * @brief Add this thread's table to the merged one
+ * @details Names replace the pointers, which are only unique within a thread.
+ */
+void StepProfiler::EndOfRun()
+{
+  G4AutoLock lock(&profileMutex);
+  for (const auto& [key, entry] : fTable) {
+    NameKey name{key.volume ? key.volume->GetName() : "(none)",
+                 key.particle ? key.particle->GetParticleName() : "(none)",
+                 key.process ? key.process->GetProcessName() : "(none)"};
+    Entry& merged = fMerged[name];
+    merged.steps += entry.steps;
+    merged.seconds += entry.seconds;
+  }
+  fTable.clear();
+}
+
+/**
+ * @brief Print the merged table and write the CSV file
+ */
+void StepProfiler::Report()
+{
+  G4AutoLock lock(&profileMutex);
+  if (fMerged.empty()) return;
+
+  std::vector<std::pair<NameKey, Entry>> rows(fMerged.begin(), fMerged.end());
+  std::sort(rows.begin(), rows.end(),
+            [](const auto& a, const auto& b) { return a.second.seconds > b.second.seconds; });
+
+  G4long totalSteps = 0;
+  G4double totalSeconds = 0.;
+  for (const auto& row : rows) {
+    totalSteps += row.second.steps;
+    totalSeconds += row.second.seconds;
+  }
+
+  // Formatted apart, so that G4cout keeps its precision and adjustment
+  std::ostringstream table;
+  table << "StepProfiler - " << totalSteps << " steps, " << std::setprecision(4) << totalSeconds
+        << " s in stepping; top " << std::min<size_t>(fTop, rows.size()) << " of " << rows.size()
+        << " (volume, particle, process):\n";
+  table << "  " << std::left << std::setw(24) << "volume" << std::setw(16) << "particle"
+        << std::setw(20) << "process" << std::right << std::setw(12) << "steps"
+        << std::setw(11) << "time [s]" << std::setw(8) << "%" << std::setw(12) << "us/step" << '\n';
+  for (size_t i = 0; i < rows.size() && G4int(i) < fTop; i++) {
+    const auto& [name, entry] = rows[i];
+    table << "  " << std::left << std::setw(24) << std::get<0>(name) << std::setw(16) << std::get<1>(name)
+          << std::setw(20) << std::get<2>(name) << std::right << std::setw(12) << entry.steps
+          << std::fixed << std::setprecision(3) << std::setw(11) << entry.seconds
+          << std::setprecision(1) << std::setw(8) << 100. * entry.seconds / totalSeconds
+          << std::setprecision(2) << std::setw(12) << 1e6 * entry.seconds / entry.steps << '\n';
+  }
+  std::string text = table.str();
+  text.pop_back();  // the last newline is G4endl's
+  G4cout << text << G4endl;
+
+  if (fFileName.empty()) return;
+  const std::string fileName = SimRunManager::ShardFileName(fFileName);
+  std::ofstream csv(fileName, std::ios::trunc);
+  if (!csv) {
+    G4cerr << "StepProfiler::Report() - Error: cannot write " << fileName << G4endl;
+    return;
+  }
+  csv << "volume,particle,process,steps,seconds\n";
+  for (const auto& [name, entry] : rows) {
+    csv << std::get<0>(name) << ',' << std::get<1>(name) << ',' << std::get<2>(name) << ','
+        << entry.steps << ',' << std::setprecision(9) << entry.seconds << '\n';
+  }
+  G4cout << "StepProfiler - Table written to " << fileName << G4endl;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file SteppingAction.cc
+ * @brief Implementation of the SteppingAction class
+ */
+
+#include "SteppingAction.hh"
+#include "KillPolicy.hh"
+#include "PhaseSpaceWriter.hh"
+#ifdef G4SIM_WITH_PROFILER
+#include "StepProfiler.hh"
+#endif
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+/**
+ * @brief Constructor implementation
+ */
+SteppingAction::SteppingAction()
+: G4UserSteppingAction()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+SteppingAction::~SteppingAction()
+{}
+
+/**
+ * @brief Record surface crossings and check the step-level kill rules
+ * @param step Step just taken
+ *
+ * In profiler builds the step is charged to the StepProfiler first.
+ */
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+#ifdef G4SIM_WITH_PROFILER
+    if (StepProfiler::IsEnabled()) StepProfiler::Instance()->Step(step);
+#endif
+
+    G4Track* track = step->GetTrack();
+
+    // Record surfaces come first so that killed tracks are still written
+    if (PhaseSpaceWriter::IsRecording() && PhaseSpaceWriter::Instance()->Record(step)) {
+        track->SetTrackStatus(fStopAndKill);
+        return;
+    }
+
+    if (!KillPolicy::HasStepRules()) return;
+    if (track->GetTrackStatus() != fAlive) return;
+
+    G4int rule = KillPolicy::CheckStep(step);
+    if (rule >= 0) {
+        KillPolicy::Count(rule);
+        track->SetTrackStatus(fStopAndKill);
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * @file TrackingAction.cc
+ * @brief Implementation of the TrackingAction class
+ */
+
+#include "TrackingAction.hh"
+#include "StepProfiler.hh"
+
+/**
+ * @brief Constructor implementation
+ */
+TrackingAction::TrackingAction()
+: G4UserTrackingAction()
+{}
+
+/**
+ * @brief Destructor implementation
+ */
+TrackingAction::~TrackingAction()
+{}
+
+/**
+ * @brief Start the profiler clock of the track
+ * @param track Track about to be transported
+ */
+void TrackingAction::PreUserTrackingAction(const G4Track*)
+{
+    if (StepProfiler::IsEnabled()) StepProfiler::Instance()->BeginOfTrack();
+}
@@ -0,0 +1,266 @@
+/**
+ * @file VolumeScoringSD.cc
+ * @brief Implementation of the per-volume scoring sensitive detectors
+ */
+
+#include "VolumeScoringSD.hh"
+#include "MySensitiveDetector.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include "TTree.h"
+
+#include <algorithm>
+#include <cfloat>
+
+/**
+ * @brief Constructor
+ * @param name Name of the sensitive detector
+ * @param hitsCollectionName Hits collection name (the branch prefix)
+ */
+VolumeScoringSD::VolumeScoringSD(const G4String& name, const G4String& hitsCollectionName)
+: G4VSensitiveDetector(name),
+  fLastVolume(nullptr),
+  fLastCopy(0),
+  fLastSlot(0),
+  fRunID(-1),
+  fNVolumes(0)
+{
+  collectionName.insert(hitsCollectionName);
+}
+
+/**
+ * @brief Create the branches of this detector in a run's event tree
+ * @param tree Event tree
+ * @param det Branch prefix
+ */
+void VolumeScoringSD::CreateBranches(TTree* tree, const std::string& det)
+{
+  tree->Branch((det + "_nHits").c_str(), &fNVolumes, (det + "_nHits/I").c_str());
+  tree->Branch((det + "_volName").c_str(), &fVolName);
+  CreateTypeBranches(tree, det);
+}
+
+/**
+ * @brief Start a new event
+ * @details The volume cache is dropped at the start of every run, as the
+ *          geometry may have been rebuilt in between.
+ */
+void VolumeScoringSD::Initialize(G4HCofThisEvent*)
+{
+  const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+  const G4int runID = run ? run->GetRunID() : -1;
+  if (runID != fRunID) {
+    fRunID = runID;
+    fSlotByVolume.clear();
+    fLastVolume = nullptr;
+  }
+  for (size_t i : fTouched) fSlots[i].touched = false;
+  fTouched.clear();
+}
+
+/**
+ * @brief Score of the volume of a step point, reset at its first use in the event
+ * @param point Pre-step point
+ * @return Slot of the volume
+ */
+VolumeScoringSD::Slot& VolumeScoringSD::SlotOf(const G4StepPoint* point)
+{
+  const G4VPhysicalVolume* volume = point->GetPhysicalVolume();
+  const G4int copy = volume->IsParameterised() ? point->GetTouchable()->GetCopyNumber() : 0;
+  if (volume != fLastVolume || copy != fLastCopy) {
+    fLastSlot = FindSlot(point, volume, copy);
+    fLastVolume = volume;
+    fLastCopy = copy;
+  }
+
+  Slot& slot = fSlots[fLastSlot];
+  if (!slot.touched) {
+    slot.touched = true;
+    slot.edep = slot.edepWeight = slot.trackLength = slot.entryWeight = 0.;
+    slot.time = DBL_MAX;
+    slot.nSteps = slot.nEntries = 0;
+    fTouched.push_back(fLastSlot);
+  }
+  return slot;
+}
+
+/**
+ * @brief Find or create the slot of a volume
+ * @param point Pre-step point in the volume
+ * @param volume Physical volume
+ * @param copy Copy number of a parameterised volume (0 otherwise)
+ * @return Slot index
+ */
+size_t VolumeScoringSD::FindSlot(const G4StepPoint* point, const G4VPhysicalVolume* volume, G4int copy)
+{
+  const auto key = std::make_pair(volume, copy);
+  auto cached = fSlotByVolume.find(key);
+  if (cached != fSlotByVolume.end()) return cached->second;
+
+  // Volumes of the same name share a slot, as MyHit volumes share a name
+  const std::string name = volume->IsParameterised()
+      ? std::string(volume->GetName()) + "_" + std::to_string(copy)
+      : std::string(volume->GetName());
+  auto named = fSlotByName.find(name);
+  size_t index;
+  if (named != fSlotByName.end()) {
+    index = named->second;
+  } else {
+    index = fSlots.size();
+    fSlots.emplace_back();
+    fSlots.back().name = name;
+    fSlotByName[name] = index;
+    fTouched.reserve(fSlots.size());
+  }
+  // Once per run: the dimensions may have changed with the geometry
+  fSlots[index].cubicVolume = point->GetTouchable()->GetSolid()->GetCubicVolume();
+  fSlotByVolume[key] = index;
+  return index;
+}
+
+/**
+ * @brief Write the volumes scored in this event to the branch data
+ */
+void VolumeScoringSD::EndOfEvent(G4HCofThisEvent*)
+{
+  std::sort(fTouched.begin(), fTouched.end());
+
+  fNVolumes = Int_t(fTouched.size());
+  fVolName.clear();
+  ClearTypeData();
+  for (size_t i : fTouched) {
+    fVolName.push_back(fSlots[i].name);
+    FillTypeData(fSlots[i]);
+  }
+
+  if (MySensitiveDetector::GetVerboseLevel() >= 1)
+    G4cout << SensitiveDetectorName << " scored " << fNVolumes << " volume(s)." << G4endl;
+}
+
+// ── CalorimeterSD ───────────────────────────────────────
+
+/**
+ * @brief Add the energy deposit of a step to its volume
+ * @param step Current step
+ * @return True if the step deposited energy
+ */
+G4bool CalorimeterSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  const G4double edep = step->GetTotalEnergyDeposit();
+  if (edep == 0.) return false;
+
+  const G4StepPoint* preStep = step->GetPreStepPoint();
+  Slot& slot = SlotOf(preStep);
+  slot.edep += edep;
+  slot.edepWeight += edep * preStep->GetWeight();
+  slot.nSteps++;
+  return true;
+}
+
+void CalorimeterSD::CreateTypeBranches(TTree* tree, const std::string& det)
+{
+  tree->Branch((det + "_E").c_str(), &fE);
+  tree->Branch((det + "_w").c_str(), &fW);
+  tree->Branch((det + "_nHitsPerVol").c_str(), &fNHitsPerVol);
+}
+
+void CalorimeterSD::ClearTypeData()
+{
+  fE.clear();
+  fW.clear();
+  fNHitsPerVol.clear();
+}
+
+void CalorimeterSD::FillTypeData(const Slot& slot)
+{
+  fE.push_back(slot.edep / MeV);
+  fW.push_back(slot.edep > 0. ? slot.edepWeight / slot.edep : 1.);
+  fNHitsPerVol.push_back(slot.nSteps);
+}
+
+// ── CounterSD ───────────────────────────────────────────
+
+/**
+ * @brief Count a track entering the volume and add its track length
+ * @param step Current step
+ * @return True (every step is scored)
+ */
+G4bool CounterSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  const G4StepPoint* preStep = step->GetPreStepPoint();
+  const G4double weight = preStep->GetWeight();
+  Slot& slot = SlotOf(preStep);
+  if (preStep->GetStepStatus() == fGeomBoundary) {
+    slot.nEntries++;
+    slot.entryWeight += weight;
+  }
+  slot.trackLength += weight * step->GetStepLength();
+  return true;
+}
+
+void CounterSD::CreateTypeBranches(TTree* tree, const std::string& det)
+{
+  tree->Branch((det + "_nEntries").c_str(), &fNEntries);
+  tree->Branch((det + "_wEntries").c_str(), &fWEntries);
+  tree->Branch((det + "_fluence").c_str(), &fFluence);
+}
+
+void CounterSD::ClearTypeData()
+{
+  fNEntries.clear();
+  fWEntries.clear();
+  fFluence.clear();
+}
+
+void CounterSD::FillTypeData(const Slot& slot)
+{
+  fNEntries.push_back(slot.nEntries);
+  fWEntries.push_back(slot.entryWeight);
+  fFluence.push_back(slot.cubicVolume > 0. ? slot.trackLength / slot.cubicVolume * cm2 : 0.);
+}
+
+// ── TimingSD ────────────────────────────────────────────
+
+/**
+ * @brief Keep the earliest time and add the energy deposit of a step
+ * @param step Current step
+ * @return True if the step deposited energy
+ */
+G4bool TimingSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  const G4double edep = step->GetTotalEnergyDeposit();
+  if (edep == 0.) return false;
+
+  Slot& slot = SlotOf(step->GetPreStepPoint());
+  slot.time = std::min(slot.time, step->GetPostStepPoint()->GetGlobalTime());
+  slot.edep += edep;
+  return true;
+}
+
+void TimingSD::CreateTypeBranches(TTree* tree, const std::string& det)
+{
+  tree->Branch((det + "_t").c_str(), &fT);
+  tree->Branch((det + "_E").c_str(), &fE);
+}
+
+void TimingSD::ClearTypeData()
+{
+  fT.clear();
+  fE.clear();
+}
+
+void TimingSD::FillTypeData(const Slot& slot)
+{
+  fT.push_back(slot.time / ns);
+  fE.push_back(slot.edep / MeV);
+}
@@ -6,6 +6,7 @@ inspecting Geant4 simulations.  Keeps the CLI workflow intact;
 this is just a convenience layer on top of the same build/G4sim binary.
 """
 
+import asyncio
 import sys
 from pathlib import Path
 
@@ -20,11 +21,12 @@ from fastapi.responses import HTMLResponse
 from fastapi.staticfiles import StaticFiles
 from fastapi.templating import Jinja2Templates
 
-from config import WEBAPP_DIR
+from config import SIM_DAEMON, WEBAPP_DIR
 from routers.config_api import router as config_router
 from routers.run_api import router as run_router
 from routers.results_api import router as results_router
 from routers.condor_api import router as condor_router
+from services.daemon import DaemonError, daemon
 
 # ---------------------------------------------------------------------------
 #  App setup
@@ -40,6 +42,28 @@ app.include_router(results_router)
 app.include_router(condor_router)
 
 
+# ---------------------------------------------------------------------------
+#  G4sim daemon: initialised in the background at start-up, so that the
+#  first run does not wait for the geometry and physics tables
+# ---------------------------------------------------------------------------
+async def _start_daemon():
+    try:
+        await daemon.ensure_started()
+    except DaemonError as e:
+        print(f"G4sim daemon not available, runs start a new process: {e}")
+
+
+@app.on_event("startup")
+async def startup():
+    if SIM_DAEMON:
+        asyncio.create_task(_start_daemon())
+
+
+@app.on_event("shutdown")
+async def shutdown():
+    await daemon.shutdown()
+
+
 # ---------------------------------------------------------------------------
 #  Pages
 # ---------------------------------------------------------------------------
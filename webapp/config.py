@@ -2,6 +2,8 @@
 Shared paths and constants for the G4sim web dashboard.
 """
 
+import os
+import tempfile
 from pathlib import Path
 
 WEBAPP_DIR  = Path(__file__).resolve().parent
@@ -11,9 +13,17 @@ CONFIG_DIR  = PROJECT_DIR / "config"
 RUNS_DIR    = WEBAPP_DIR / "runs"
 G4SIM_BIN   = BUILD_DIR / "G4sim"
 
+# Local runs go to a persistent G4sim daemon (initialised once) instead of a
+# fresh process per run; it is started with the dashboard
+SIM_DAEMON  = True
+DAEMON_SOCKET = Path(tempfile.gettempdir()) / f"g4sim_{os.getuid()}.sock"
+DAEMON_LOG  = RUNS_DIR / "daemon.log"
+DAEMON_START_TIMEOUT = 600   # seconds for geometry and physics tables
+
 # HTCondor settings
 CONDOR_OS   = "el9"          # Set to "el7", "el8", or "el9" to match your cluster
 CONDOR_JOB_CATEGORY = "short"  # Job category required by the cluster (e.g. "short", "long")
+CONDOR_TABLE_CACHE = "/tmp/g4sim_tables"  # Node-local physics table cache ("" = build in every job)
 
 # Ensure the runs directory exists
 RUNS_DIR.mkdir(exist_ok=True)
@@ -12,7 +12,7 @@ from fastapi import APIRouter
 from fastapi.responses import FileResponse, JSONResponse
 
 from config import CONFIG_DIR, RUNS_DIR
-from services.geometry import add_geometry_traces
+from services.geometry import add_geometry_traces, placement_positions
 
 router = APIRouter(prefix="/api/results", tags=["results"])
 
@@ -170,7 +170,12 @@ async def plot_branch(run_id: str, branch: str, file: str = ""):
 
 @router.get("/{run_id}/plot3d")
 async def plot_3d(run_id: str, file: str = ""):
-    """Return Plotly JSON for a 3D scatter of hit positions overlaid with geometry wireframes."""
+    """Return Plotly JSON for a 3D map of the detector output overlaid with geometry wireframes.
+
+    Tracker detectors show their hit positions.  The volume-scoring types
+    (calorimeter, counter, timing) have no positions; their summed score per
+    volume is drawn at the volume's placement.
+    """
     run_dir = _safe_run_path(run_id)
     if run_dir is None:
         return JSONResponse({"error": "Invalid run id"}, status_code=400)
@@ -191,12 +196,13 @@ async def plot_3d(run_id: str, file: str = ""):
     tree = f["events"]
     keys = tree.keys()
 
-    # Find detector prefixes by looking for *_x branches
-    detectors = [k.replace("_x", "") for k in keys if k.endswith("_x")]
+    # Every detector type writes <det>_nHits
+    detectors = [k[:-len("_nHits")] for k in keys if k.endswith("_nHits")]
 
     fig = go.Figure()
 
     # ── Overlay geometry volumes ────────────────────────────
+    positions = {}
     meta_path = run_dir / "meta.json"
     if meta_path.exists():
         meta = json.loads(meta_path.read_text())
@@ -205,9 +211,14 @@ async def plot_3d(run_id: str, file: str = ""):
             geom = json.loads(geom_path.read_text())
             materials = geom.get("materials", {})
             add_geometry_traces(fig, geom, materials)
+            positions = placement_positions(geom)
 
     # ── Scatter plot of hits ────────────────────────────────
+    unplaced = 0
     for det in detectors:
+        if f"{det}_x" not in keys:
+            unplaced += _add_volume_scores(fig, tree, keys, det, positions)
+            continue
         try:
             x = tree[f"{det}_x"].array(library="np")
             y = tree[f"{det}_y"].array(library="np")
@@ -232,8 +243,11 @@ async def plot_3d(run_id: str, file: str = ""):
         except Exception:
             continue
 
+    title = "Detector output + geometry (3D)"
+    if unplaced:
+        title += f" — {unplaced} scored volume(s) without a known position not shown"
     fig.update_layout(
-        title="Hit positions + geometry (3D)",
+        title=title,
         scene=dict(
             xaxis_title="x [mm]", yaxis_title="y [mm]", zaxis_title="z [mm]",
             aspectmode="data",
@@ -243,3 +257,56 @@ async def plot_3d(run_id: str, file: str = ""):
         margin=dict(l=0, r=0, t=40, b=0),
     )
     return {"plotJSON": fig.to_json()}
+
+
+# Score shown for each volume-scoring type: branch, label
+_VOLUME_SCORES = [
+    ("_E", "energy deposit [MeV]"),    # calorimeter, timing
+    ("_nEntries", "entries"),          # counter
+]
+
+
+def _add_volume_scores(fig, tree, keys, det: str, positions: dict) -> int:
+    """Add the summed score per volume of a volume-scoring detector.
+
+    Returns the number of scored volumes that could not be placed.
+    """
+    branch, label = next(((b, l) for b, l in _VOLUME_SCORES if f"{det}{b}" in keys), (None, None))
+    if branch is None or f"{det}_volName" not in keys:
+        return 0
+    try:
+        names = tree[f"{det}_volName"].array(library="np")
+        values = tree[f"{det}{branch}"].array(library="np")
+    except Exception:
+        return 0
+
+    totals = {}
+    for event_names, event_values in zip(names, values):
+        for name, value in zip(event_names, np.atleast_1d(event_values)):
+            totals[str(name)] = totals.get(str(name), 0.0) + float(value)
+
+    xs, ys, zs, scores, text = [], [], [], [], []
+    unplaced = 0
+    for name, total in totals.items():
+        if name not in positions:
+            unplaced += 1
+            continue
+        for pos in positions[name]:
+            xs.append(float(pos[0]))
+            ys.append(float(pos[1]))
+            zs.append(float(pos[2]))
+            scores.append(total)
+            text.append(f"{name}: {total:.4g} {label}")
+    if not xs:
+        return unplaced
+
+    fig.add_trace(go.Scatter3d(
+        x=xs, y=ys, z=zs,
+        mode="markers",
+        marker=dict(size=8, color=scores, colorscale="Viridis", showscale=True,
+                    colorbar=dict(title=f"{det} {label}")),
+        text=text,
+        hoverinfo="text",
+        name=f"{det} ({label})",
+    ))
+    return unplaced
@@ -2,7 +2,7 @@
 HTCondor job submission and management for G4sim batch runs.
 
 Handles:
-  - Generating per-job macros with distinct random seeds & output files
+  - Generating per-job macros with a shared master seed, per-job event ranges & output files
   - Writing a Condor submit description (.sub) file
   - Submitting, querying, and cancelling Condor jobs
   - Merging per-job ROOT output files with hadd
@@ -17,7 +17,10 @@ from datetime import datetime
 from pathlib import Path
 from typing import Optional
 
-from config import BUILD_DIR, CONDOR_JOB_CATEGORY, CONDOR_OS, G4SIM_BIN, PROJECT_DIR, RUNS_DIR
+from config import (
+    BUILD_DIR, CONDOR_JOB_CATEGORY, CONDOR_OS, CONDOR_TABLE_CACHE, G4SIM_BIN, PROJECT_DIR, RUNS_DIR,
+)
+from services.simulation import read_progress
 
 logger = logging.getLogger("condor")
 
@@ -114,12 +117,16 @@ async def submit_condor_jobs(
     base_output = body.get("outputFile", "G4sim.root").replace(".root", "")
 
     # ── Per-job macro files ────────────────────────
+    # All jobs share one master seed; job j simulates events
+    # [j*nEvents, (j+1)*nEvents) of the run, so every event is seeded the
+    # same way however the run is split.
+    seed = _make_seed()
+    n_events = int(body.get("nEvents", 10000))
+    meta["masterSeed"] = seed
     for j in range(n_jobs):
         job_output = f"{base_output}_{j:03d}.root"
         macro_text = macro_builder(body, run_dir, job_output)
-        # Insert a unique random seed right after /run/initialize
-        seed = _make_seed(j)
-        macro_text = _inject_seed(macro_text, seed)
+        macro_text = _inject_seed(macro_text, seed, j * n_events)
         (run_dir / "mac" / f"run_{j:03d}.mac").write_text(macro_text)
 
     # ── Condor submit description ──────────────────────────
@@ -256,6 +263,7 @@ async def get_condor_status(run_id: str) -> dict:
             "process": j,
             "status": status_str,
             "output_exists": output_file.exists(),
+            "progress": read_progress(run_dir / "log" / f"progress_{j:03d}.json"),
         })
 
     overall = meta.get("status", "condor_submitted")
@@ -368,18 +376,14 @@ async def merge_output(run_id: str) -> dict:
 #  Internal helpers
 # ---------------------------------------------------------------------------
 
-def _make_seed(job_index: int) -> int:
-    """Generate a deterministic-but-unique seed per job."""
-    import time
-    # Combine current timestamp (seconds) with job index
-    base = int(datetime.now().timestamp()) & 0x7FFFFFFF
-    return (base + job_index * 7919) & 0x7FFFFFFF     # prime spacing
+def _make_seed() -> int:
+    """Generate a master seed for a submission (never 0, which means unseeded)."""
+    return (int(datetime.now().timestamp()) & 0x7FFFFFFF) or 1
 
 
-def _inject_seed(macro_text: str, seed: int) -> str:
-    """Insert /random/setSeeds after /run/initialize."""
-    seed2 = (seed * 31 + 17) & 0x7FFFFFFF
-    seed_cmd = f"/random/setSeeds {seed} {seed2}"
+def _inject_seed(macro_text: str, seed: int, first_event: int) -> str:
+    """Insert the master seed and the job's first event after /run/initialize."""
+    seed_cmd = f"/random/setMasterSeed {seed}\n/random/setFirstEvent {first_event}"
     return macro_text.replace(
         "/run/initialize",
         f"/run/initialize\n{seed_cmd}",
@@ -389,10 +393,13 @@ def _inject_seed(macro_text: str, seed: int) -> str:
 
 def _build_submit_file(run_dir: Path, n_jobs: int) -> str:
     """Generate a Condor submit description."""
+    # Jobs on the same node share the physics tables built by the first one
+    table_cache = f"--table-cache {CONDOR_TABLE_CACHE} " if CONDOR_TABLE_CACHE else ""
     lines = [
         f"universe   = vanilla",
         f"executable = {G4SIM_BIN}",
-        f"arguments  = {run_dir}/mac/run_$INT(Process,%03d).mac",
+        f"arguments  = --headless {table_cache}--progress-file {run_dir}/log/progress_$INT(Process,%03d).json "
+        f"{run_dir}/mac/run_$INT(Process,%03d).mac",
         f"initialdir = {PROJECT_DIR}",
         f"getenv     = True",
         f"",
@@ -0,0 +1,174 @@
+"""
+Persistent G4sim daemon — one initialised G4sim serving runs over a Unix socket.
+
+``G4sim --daemon <socket>`` builds the geometry and the physics tables once and
+then executes one request per line: a UI command, or ``status`` / ``abort`` /
+``reset`` / ``shutdown``.  It answers with JSON lines: ``log`` and ``progress`` messages
+while a request runs, then one ``done`` message naming the request.  Runs
+started from the dashboard therefore skip the start-up of a fresh process.
+"""
+
+import asyncio
+import json
+import logging
+from pathlib import Path
+from typing import Callable, Optional
+
+from config import DAEMON_LOG, DAEMON_SOCKET, DAEMON_START_TIMEOUT, G4SIM_BIN, PROJECT_DIR
+
+logger = logging.getLogger("daemon")
+
+LINE_LIMIT = 16 * 1024 * 1024  # longest reply line (log lines of big macros)
+
+
+class DaemonError(RuntimeError):
+    """The daemon could not be started or the connection to it was lost."""
+
+
+class SimulationDaemon:
+    """Client of a G4sim daemon that it starts (and restarts) on demand."""
+
+    def __init__(self, socket_path: Path = DAEMON_SOCKET):
+        self.socket_path = socket_path
+        self.proc: Optional[asyncio.subprocess.Process] = None
+        self.reader: Optional[asyncio.StreamReader] = None
+        self.writer: Optional[asyncio.StreamWriter] = None
+        self.lock = asyncio.Lock()          # one request at a time
+        self.start_lock = asyncio.Lock()
+        self.aborted = False
+
+    @property
+    def alive(self) -> bool:
+        return self.proc is not None and self.proc.returncode is None and self.writer is not None
+
+    async def ensure_started(self) -> None:
+        """Start the daemon and connect to it, unless it is already up."""
+        async with self.start_lock:
+            if self.alive:
+                return
+            await self._close()
+            if self.proc is not None and self.proc.returncode is None:
+                self.proc.kill()
+                await self.proc.wait()
+            self.socket_path.unlink(missing_ok=True)
+            log = open(DAEMON_LOG, "a")
+            try:
+                self.proc = await asyncio.create_subprocess_exec(
+                    str(G4SIM_BIN), "--daemon", str(self.socket_path),
+                    stdout=log, stderr=asyncio.subprocess.STDOUT, cwd=str(PROJECT_DIR),
+                )
+            finally:
+                log.close()
+
+            # Initialisation (geometry, physics tables) happens before it listens
+            loop = asyncio.get_running_loop()
+            deadline = loop.time() + DAEMON_START_TIMEOUT
+            while True:
+                if self.proc.returncode is not None:
+                    raise DaemonError(f"G4sim daemon exited with code {self.proc.returncode}, see {DAEMON_LOG}")
+                try:
+                    self.reader, self.writer = await asyncio.open_unix_connection(
+                        str(self.socket_path), limit=LINE_LIMIT)
+                    break
+                except (FileNotFoundError, ConnectionRefusedError):
+                    if loop.time() > deadline:
+                        self.proc.kill()
+                        raise DaemonError(f"G4sim daemon did not start within {DAEMON_START_TIMEOUT} s")
+                    await asyncio.sleep(0.2)
+
+            ready = await self._read()
+            logger.info("G4sim daemon ready (pid %s)", ready.get("pid"))
+
+    async def request(self, line: str, on_message: Optional[Callable[[dict], None]] = None) -> dict:
+        """Send one request and return its ``done`` message.
+
+        ``log`` and ``progress`` messages that arrive meanwhile are passed to
+        ``on_message``.
+        """
+        await self.ensure_started()
+        async with self.lock:
+            self.writer.write(line.encode() + b"\n")
+            await self.writer.drain()
+            while True:
+                msg = await self._read()
+                # done messages of abort/status sent during a run have their own request
+                if msg.get("type") == "done" and msg.get("request") == line.strip():
+                    return msg
+                if on_message and msg.get("type") != "done":
+                    on_message(msg)
+
+    async def run_macro(self, macro_path: Path, progress_file: Path,
+                        on_message: Optional[Callable[[dict], None]] = None) -> bool:
+        """Execute a run macro command by command; stop at the first failure.
+
+        The run settings are reset first, so that a setting of an earlier run
+        which this macro does not repeat has its fresh-process default.  The
+        geometry is rebuilt after every ``/detector/setGeometryFile`` (a fresh
+        process would read it at initialisation), in place when only
+        positions, dimensions or materials changed.
+        """
+        self.aborted = False
+        commands = ["reset", f"/output/progressFile {progress_file}"]
+        for line in macro_path.read_text().splitlines():
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            commands.append(line)
+            if line.startswith("/detector/setGeometryFile"):
+                commands.append("/detector/rebuild")
+
+        for command in commands:
+            done = await self.request(command, on_message)
+            if not done.get("ok"):
+                if on_message:
+                    on_message({"type": "log", "stream": "err",
+                                "text": f"Command failed ({done.get('code', done.get('error', done.get('failed')))}): {command}"})
+                return False
+            if self.aborted:
+                return False
+        return True
+
+    async def abort(self) -> bool:
+        """End the current run after its current event (does not wait)."""
+        if not self.alive:
+            return False
+        self.aborted = True
+        self.writer.write(b"abort\n")
+        await self.writer.drain()
+        return True
+
+    async def status(self) -> dict:
+        """Status of the daemon (after the request in progress, if any)."""
+        return await self.request("status")
+
+    async def shutdown(self) -> None:
+        """Stop the daemon."""
+        if self.alive:
+            try:
+                self.writer.write(b"shutdown\n")
+                await self.writer.drain()
+                await asyncio.wait_for(self.proc.wait(), timeout=10)
+            except (OSError, asyncio.TimeoutError):
+                self.proc.kill()
+        await self._close()
+
+    async def _read(self) -> dict:
+        """Next reply line; raises DaemonError if the daemon has gone."""
+        try:
+            data = await self.reader.readline()
+        except (OSError, ValueError) as e:
+            data, error = b"", e
+        else:
+            error = None
+        if not data:
+            await self._close()
+            raise DaemonError(f"Connection to the G4sim daemon lost ({error or 'closed'}), see {DAEMON_LOG}")
+        return json.loads(data)
+
+    async def _close(self) -> None:
+        if self.writer is not None:
+            self.writer.close()
+        self.reader = self.writer = None
+
+
+daemon = SimulationDaemon()
@@ -762,3 +762,28 @@ def add_geometry_traces(fig, geom: dict, materials: dict) -> None:
 
             _add_mesh_trace(fig, verts, ti, tj, tk, R, t, color,
                             vol.get("g4name") or vol.get("name", vtype))
+
+
+def placement_positions(geom: dict) -> dict:
+    """Return world positions of the placed volumes, keyed by physical-volume name.
+
+    The name is the placement's ``name`` or else the volume's, as in
+    GeometryParser.  Assemblies and pattern placements are not resolved.
+    """
+    volumes = geom.get("volumes", [])
+    volumes_by_name = {v["name"]: v for v in volumes if "name" in v}
+    transform_cache = {}
+    positions = {}
+
+    for vol in volumes:
+        if vol.get("type", "") == "assembly":
+            continue
+        for pl in vol.get("placements", []):
+            if "pattern" in pl:
+                continue
+            R_par, t_par = _get_world_transform(
+                pl.get("parent", "World"), volumes_by_name, transform_cache)
+            t_loc = np.array([pl.get("x", 0), pl.get("y", 0), pl.get("z", 0)])
+            name = pl.get("name", vol.get("name", ""))
+            positions.setdefault(name, []).append(R_par @ t_loc + t_par)
+    return positions
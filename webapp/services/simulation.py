@@ -7,17 +7,31 @@ import json
 from datetime import datetime
 from pathlib import Path
 
-from config import G4SIM_BIN, PROJECT_DIR, RUNS_DIR
+from config import G4SIM_BIN, PROJECT_DIR, RUNS_DIR, SIM_DAEMON
+from services.daemon import DaemonError, daemon
 
-
-# In-memory state for the currently running simulation
+# In-memory state for the currently running simulation ("proc" is the
+# monitoring task for runs in the daemon)
 current_process: dict = {"proc": None, "info": None}
 
 
 async def start_simulation(run_dir: Path, macro_path: Path, meta: dict) -> None:
-    """Launch G4sim as a subprocess and start monitoring it."""
+    """Run the macro in the G4sim daemon, or launch G4sim as a subprocess, and monitor it."""
+    if SIM_DAEMON:
+        current_process["info"] = {
+            "run_dir": str(run_dir),
+            "meta": meta,
+            "log_lines": [],
+            "daemon": True,
+        }
+        current_process["proc"] = asyncio.create_task(_run_in_daemon(run_dir, macro_path, meta))
+        return
+
     proc = await asyncio.create_subprocess_exec(
-        str(G4SIM_BIN), str(macro_path),
+        str(G4SIM_BIN),
+        "--headless",
+        "--progress-file", str(progress_path(run_dir)),
+        str(macro_path),
         stdout=asyncio.subprocess.PIPE,
         stderr=asyncio.subprocess.STDOUT,
         cwd=str(PROJECT_DIR),
@@ -34,6 +48,58 @@ async def start_simulation(run_dir: Path, macro_path: Path, meta: dict) -> None:
 LOG_BUFFER_MAX = 50_000  # keep last N lines in memory
 
 
+def progress_path(run_dir: Path) -> Path:
+    """Progress file G4sim keeps up to date for a local run."""
+    return run_dir / "log" / "progress.json"
+
+
+def read_progress(path: Path) -> dict | None:
+    """Load a G4sim progress file (written atomically), or None if absent."""
+    try:
+        return json.loads(path.read_text())
+    except (OSError, ValueError):
+        return None
+
+
+def _add_log_line(flog, text: str) -> None:
+    """Write a log line to the run log and the in-memory buffer."""
+    flog.write(text + "\n")
+    if current_process["info"]:
+        buf = current_process["info"]["log_lines"]
+        buf.append(text)
+        if len(buf) > LOG_BUFFER_MAX:
+            del buf[: len(buf) - LOG_BUFFER_MAX]
+
+
+def _finish(run_dir: Path, meta: dict, status: str) -> None:
+    """Finalise the run metadata and clear the current run."""
+    meta["status"] = status
+    meta["finished"] = datetime.now().strftime("%Y%m%d_%H%M%S")
+    (run_dir / "meta.json").write_text(json.dumps(meta, indent=2))
+
+    current_process["proc"] = None
+    current_process["info"] = None
+
+
+async def _run_in_daemon(run_dir: Path, macro_path: Path, meta: dict) -> None:
+    """Execute the run macro in the daemon (started if needed), collecting its output."""
+    log_file = run_dir / "log" / "log.txt"
+    log_file.parent.mkdir(exist_ok=True)
+    with open(log_file, "w") as flog:
+        def on_message(msg: dict) -> None:
+            if msg.get("type") == "log":
+                for text in msg["text"].splitlines() or [""]:
+                    _add_log_line(flog, text)
+
+        try:
+            ok = await daemon.run_macro(macro_path, progress_path(run_dir), on_message)
+            status = "completed" if ok else ("aborted" if daemon.aborted else "error (command failed)")
+        except (DaemonError, OSError, ValueError) as e:
+            _add_log_line(flog, str(e))
+            status = "error (daemon lost)"
+    _finish(run_dir, meta, status)
+
+
 async def _monitor_process(proc, run_dir: Path, meta: dict) -> None:
     """Read stdout until the process exits, then finalise metadata."""
     log_file = run_dir / "log" / "log.txt"
@@ -45,24 +111,12 @@ async def _monitor_process(proc, run_dir: Path, meta: dict) -> None:
                 if not data:
                     break
                 for text in data.decode(errors="replace").splitlines():
-                    flog.write(text + "\n")
-                    if current_process["info"]:
-                        buf = current_process["info"]["log_lines"]
-                        buf.append(text)
-                        if len(buf) > LOG_BUFFER_MAX:
-                            del buf[: len(buf) - LOG_BUFFER_MAX]
+                    _add_log_line(flog, text)
     except Exception:
         pass
 
     await proc.wait()
-    meta["status"] = (
-        "completed" if proc.returncode == 0 else f"error (code {proc.returncode})"
-    )
-    meta["finished"] = datetime.now().strftime("%Y%m%d_%H%M%S")
-    (run_dir / "meta.json").write_text(json.dumps(meta, indent=2))
-
-    current_process["proc"] = None
-    current_process["info"] = None
+    _finish(run_dir, meta, "completed" if proc.returncode == 0 else f"error (code {proc.returncode})")
 
 
 async def stop_simulation() -> str:
@@ -70,6 +124,9 @@ async def stop_simulation() -> str:
     proc = current_process["proc"]
     if proc is None:
         return "no simulation running"
+    if current_process["info"].get("daemon"):
+        # The daemon finishes the current event and stays up for the next run
+        return "aborted" if await daemon.abort() else "daemon not running"
     try:
         proc.kill()
     except ProcessLookupError:
@@ -86,6 +143,7 @@ def get_status() -> dict:
         "running": True,
         "runDir": info["run_dir"],
         "meta": info["meta"],
+        "progress": read_progress(progress_path(Path(info["run_dir"]))),
         "logTail": info["log_lines"][-100:],
         "logLength": len(info["log_lines"]),
     }
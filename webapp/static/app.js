@@ -725,7 +725,7 @@ $('btn-plot3d').addEventListener('click', async () => {
   const runId = $('result-run-select').value;
   if (!runId) return;
 
-  $('plot-container').innerHTML = '<p>Loading 3D hit map…</p>';
+  $('plot-container').innerHTML = '<p>Loading 3D detector map…</p>';
   const qs = _selectedFileQS();
   const res = await fetch(`/api/results/${runId}/plot3d${qs}`).then(json);
   if (res.error) {